@@ -0,0 +1,204 @@
+// Number of epochs adapted to the measured noise.
+// ======================================================================
+// Copyright (c) 2025 CS GROUP
+//
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// ======================================================================
+//
+// Authors:
+// - Luc Hermitte, initial author
+//
+// ======================================================================
+//
+// Defines:
+// - adaptive_outcome: what an adaptive run has achieved.
+// - AdaptiveEpochs: runs a benchmark with as many epochs as needed for
+//   the confidence interval of its median to narrow to a target.
+
+#ifndef adaptive_epochs_hpp
+#define adaptive_epochs_hpp
+
+#include "nanobench_html_graph_renderer.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/** Outcome of `AdaptiveEpochs::run()`. */
+struct adaptive_outcome
+{
+    std::size_t epochs;    ///< Number of epochs of the recorded result
+    double      error;     ///< Its `AdaptiveEpochs::uncertainty()`, 0.01 for 1%
+    bool        converged; ///< Whether `error` is below the target
+};
+
+/**
+ * Chooses the number of epochs of each benchmark from its noise,
+ * instead of a hand-tuned `Bench::epochs()`.
+ *
+ * The benchmark is first run with `min_epochs` epochs, which measures
+ * the `uncertainty()` of the median elapsed time, and how long an epoch
+ * takes. As the uncertainty decreases as the square root of the number
+ * of epochs, while it's above the target, the benchmark is run again
+ * with the number of epochs expected to reach it -- re-estimated from
+ * the latest run, within the time budget and `max_epochs`. Each run
+ * replaces the result of the previous one, and reuses its iterations
+ * per epoch: the runs are comparable, and the iteration count is only
+ * searched once.
+ *
+ * The median absolute percent error displayed in the plots is not used:
+ * it measures the spread of the epochs, which more epochs don't reduce.
+ *
+ * Quiet kernels cost `min_epochs` epochs; noisy ones get up to the time
+ * budget. The number of epochs can be seen in the plots with
+ * `HtmlGraphRenderer::showepochs()`.
+ *
+ * ```c++
+ * AdaptiveEpochs adaptive(0.01, std::chrono::seconds(5));
+ * auto const outcome = adaptive.run(bench, "name", [&]() { ... });
+ * ```
+ */
+class AdaptiveEpochs
+{
+public:
+    using duration = std::chrono::duration<double>;
+
+    /**
+     * Constructor.
+     * @param[in] target_error  `uncertainty()` to reach, 0.01 for 1%.
+     * @param[in] budget        Time allowed to each benchmark, all its
+     *                          runs included.
+     * @param[in] min_epochs    Epochs of the first run.
+     * @param[in] max_epochs    Maximum epochs of a run.
+     * @pre `target_error > 0`, `0 < min_epochs <= max_epochs`
+     */
+    explicit AdaptiveEpochs(
+            double target_error = 0.01, duration budget = std::chrono::seconds(10),
+            std::size_t min_epochs = 11, std::size_t max_epochs = 1000) noexcept
+    : m_target_error(target_error)
+    , m_budget(budget)
+    , m_min_epochs(min_epochs)
+    , m_max_epochs(max_epochs)
+    {}
+
+    [[nodiscard]] double      target_error() const noexcept { return m_target_error; }
+    [[nodiscard]] duration    budget() const noexcept { return m_budget; }
+    [[nodiscard]] std::size_t min_epochs() const noexcept { return m_min_epochs; }
+    [[nodiscard]] std::size_t max_epochs() const noexcept { return m_max_epochs; }
+
+    /**
+     * Relative half-width of the 95% confidence interval of the median
+     * elapsed time of `r`, 0.01 for 1%.
+     *
+     * The interval is bounded by the order statistics of ranks
+     * `n/2 -/+ 1.96 sqrt(n)/2`, which holds whatever the distribution of
+     * the epochs: its width shrinks as `1/sqrt(n)`.
+     * @return 0 if `r` has no epochs, or a null median.
+     */
+    [[nodiscard]] static double uncertainty(ankerl::nanobench::Result const& r)
+    {
+        using Measure = ankerl::nanobench::Result::Measure;
+        std::size_t const n = r.size();
+        std::vector<double> elapsed(n);
+        for (std::size_t i = 0; i != n; ++i) {
+            elapsed[i] = r.get(i, Measure::elapsed);
+        }
+        std::sort(elapsed.begin(), elapsed.end());
+        double const median = n == 0 ? 0.0 : (elapsed[(n - 1) / 2] + elapsed[n / 2]) / 2;
+        if (median <= 0) {
+            return 0.0;
+        }
+        double const      spread = 1.96 * std::sqrt(double(n)) / 2;
+        std::size_t const lo     = std::size_t(std::max(0.0, std::floor(double(n) / 2 - spread)));
+        std::size_t const hi     = std::min(n - 1, std::size_t(std::ceil(double(n) / 2 + spread)));
+        return (elapsed[hi] - elapsed[lo]) / (2 * median);
+    }
+
+    /**
+     * Benchmarks `op` with the number of epochs that reaches the target
+     * error, and appends its result to `bench`.
+     *
+     * The runs that don't reach the target are rolled back: only the
+     * last one is recorded in `bench` -- though every run is printed to
+     * its output. The number of epochs, and of iterations per epoch, of
+     * `bench` are left unchanged.
+     * @return The number of epochs, and the error, of the recorded result.
+     * @throw Whatever `Bench::run()` may throw.
+     */
+    template <typename Op>
+    adaptive_outcome run(ankerl::nanobench::Bench& bench, std::string const& name, Op&& op) const
+    {
+        using Measure    = ankerl::nanobench::Result::Measure;
+        using clock      = std::chrono::steady_clock;
+        auto const start = clock::now();
+
+        std::size_t const        previous_epochs     = bench.epochs();
+        std::uint64_t const      previous_iterations = bench.epochIterations();
+        ankerl::nanobench::Bench const before        = bench;
+
+        std::size_t epochs = m_min_epochs;
+        double      error  = 0;
+        for (;;) {
+            auto const run_start = clock::now();
+            bench.epochs(epochs).run(name, op);
+            auto const& r        = bench.results().back();
+            error                = uncertainty(r);
+            if (error <= m_target_error || epochs >= m_max_epochs) break;
+
+            // Warmup included: a pessimistic guess
+            double const per_epoch  = duration(clock::now() - run_start).count() / double(epochs);
+            double const affordable = per_epoch > 0 ? (m_budget - (clock::now() - start)).count() / per_epoch
+                                                    : double(m_max_epochs);
+            double const ratio      = error / m_target_error;
+            double const wanted     = std::ceil(double(epochs) * ratio * ratio);
+            auto const   next       = std::size_t(std::max(0.0, std::min({wanted, affordable, double(m_max_epochs)})));
+            if (next <= epochs) break;
+
+            // The iteration count found by the first run is kept
+            std::uint64_t iterations = previous_iterations;
+            if (iterations == 0) {
+                std::vector<double> counts(r.size());
+                for (std::size_t i = 0; i != r.size(); ++i) counts[i] = r.get(i, Measure::iterations);
+                std::nth_element(counts.begin(), counts.begin() + counts.size() / 2, counts.end());
+                iterations = counts.empty() ? 0 : std::uint64_t(counts[counts.size() / 2]);
+            }
+            bench  = before;
+            bench.epochIterations(iterations);
+            epochs = next;
+        }
+        bench.epochs(previous_epochs).epochIterations(previous_iterations);
+        return {epochs, error, error <= m_target_error};
+    }
+
+private:
+    double      m_target_error;
+    duration    m_budget;
+    std::size_t m_min_epochs;
+    std::size_t m_max_epochs;
+};
+
+#endif // adaptive_epochs_hpp
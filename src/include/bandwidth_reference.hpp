@@ -0,0 +1,183 @@
+// Per-host reference bandwidths.
+// ======================================================================
+// Copyright (c) 2025 CS GROUP
+//
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// ======================================================================
+//
+// Authors:
+// - Luc Hermitte, initial author
+//
+// ======================================================================
+//
+// Defines:
+// - BandwidthReference: bandwidths measured by the STREAM-like suite,
+//   stored in a per-host file that other reports load to compare their
+//   throughputs to the peak.
+
+#ifndef bandwidth_reference_hpp
+#define bandwidth_reference_hpp
+
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+
+#if __has_include(<unistd.h>)
+#  include <unistd.h>
+#endif
+
+/**
+ * Bandwidths measured on the current host, per kernel, memory level,
+ * and number of threads.
+ *
+ * The file is a plain text file, one measure per line:
+ * ```
+ * # kernel level threads bytes_per_second
+ * triad DRAM 8 2.31e+10
+ * ```
+ * See `stream_bandwidth.cpp` that produces it.
+ */
+class BandwidthReference
+{
+public:
+    /**
+     * Per-host file where the reference bandwidths are stored.
+     * `$NANOBENCH_VIOLIN_BANDWIDTH` if set, otherwise
+     * `$XDG_CACHE_HOME/nanobench-violin/bandwidth-<hostname>.txt`, with
+     * `~/.cache` as default cache directory.
+     * @throw std::bad_alloc if memory is exhausted. Unlikely.
+     */
+    [[nodiscard]]
+    static std::filesystem::path default_path()
+    {
+        if (char const* env = std::getenv("NANOBENCH_VIOLIN_BANDWIDTH")) return env;
+        std::filesystem::path dir;
+        if (char const* xdg = std::getenv("XDG_CACHE_HOME")) {
+            dir = xdg;
+        } else if (char const* home = std::getenv("HOME")) {
+            dir = std::filesystem::path(home) / ".cache";
+        }
+        return dir / "nanobench-violin" / ("bandwidth-" + hostname() + ".txt");
+    }
+
+    /**
+     * Loads the reference from `path`.
+     * @return An empty reference if the file doesn't exist.
+     * @throw std::runtime_error if the file is ill-formed.
+     */
+    [[nodiscard]]
+    static BandwidthReference load(std::filesystem::path const& path = default_path())
+    {
+        BandwidthReference res;
+        std::ifstream      in(path);
+        std::string        line;
+        while (std::getline(in, line)) {
+            if (line.empty() || line[0] == '#') continue;
+            std::istringstream l(line);
+            std::string        kernel, level;
+            unsigned           threads = 0;
+            double             bandwidth = 0;
+            if (!(l >> kernel >> level >> threads >> bandwidth)) {
+                throw std::runtime_error("Invalid bandwidth reference line in " + path.string() + ": " + line);
+            }
+            res.set(kernel, level, threads, bandwidth);
+        }
+        return res;
+    }
+
+    /**
+     * Saves the reference to `path`, creating its directory if needed.
+     * @throw std::runtime_error if the file cannot be written.
+     * @throw std::filesystem::filesystem_error if the directory cannot be created.
+     */
+    void save(std::filesystem::path const& path = default_path()) const
+    {
+        if (path.has_parent_path()) std::filesystem::create_directories(path.parent_path());
+        std::ofstream out(path);
+        out << "# kernel level threads bytes_per_second\n";
+        for (auto const& [k, bandwidth] : m_bandwidths) {
+            out << std::get<0>(k) << ' ' << std::get<1>(k) << ' ' << std::get<2>(k) << ' ' << bandwidth << '\n';
+        }
+        if (!out) throw std::runtime_error("Cannot write bandwidth reference to " + path.string());
+    }
+
+    /**
+     * Records a bandwidth.
+     * @param[in] kernel     "copy", "scale", "add", "triad"...
+     * @param[in] level      "L1", "L2"... or "DRAM".
+     * @param[in] threads    Number of threads.
+     * @param[in] bandwidth  Bytes per second.
+     * @pre `kernel` and `level` have no white space.
+     */
+    void set(std::string const& kernel, std::string const& level, unsigned threads, double bandwidth)
+    {
+        m_bandwidths[{kernel, level, threads}] = bandwidth;
+    }
+
+    /** Recorded bandwidth, in bytes per second. */
+    [[nodiscard]]
+    std::optional<double> get(std::string const& kernel, std::string const& level, unsigned threads) const
+    {
+        auto const it = m_bandwidths.find({kernel, level, threads});
+        if (it == m_bandwidths.end()) return std::nullopt;
+        return it->second;
+    }
+
+    /**
+     * Best bandwidth measured at `level`, whatever the kernel and the
+     * number of threads.
+     * @return 0 if nothing has been recorded for `level`.
+     */
+    [[nodiscard]]
+    double peak(std::string const& level = "DRAM") const noexcept
+    {
+        double res = 0;
+        for (auto const& [k, bandwidth] : m_bandwidths) {
+            if (std::get<1>(k) == level) res = std::max(res, bandwidth);
+        }
+        return res;
+    }
+
+    [[nodiscard]] bool empty() const noexcept { return m_bandwidths.empty(); }
+
+private:
+    static std::string hostname()
+    {
+#if __has_include(<unistd.h>)
+        char name[256] = {};
+        if (::gethostname(name, sizeof(name) - 1) == 0 && name[0]) return name;
+#endif
+        return "localhost";
+    }
+
+    std::map<std::tuple<std::string, std::string, unsigned>, double> m_bandwidths;
+};
+
+#endif // bandwidth_reference_hpp
@@ -0,0 +1,217 @@
+// Comparison of nanobench results against a previous run.
+// ======================================================================
+// Copyright (c) 2025 CS GROUP
+//
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// ======================================================================
+//
+// Authors:
+// - Luc Hermitte, initial author
+//
+// ======================================================================
+//
+// Defines:
+// - mann_whitney_greater(): one-sided Mann-Whitney U test.
+// - baseline_comparison: outcome of the comparison of a result.
+// - BenchBaseline: results of a previous run, read from a JSON Lines
+//   sidecar, to compare new results to.
+
+#ifndef bench_baseline_hpp
+#define bench_baseline_hpp
+
+#include "nanobench_sidecar.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * One-sided Mann-Whitney U test: probability to observe samples `a` at
+ * least as much shifted above samples `b` as they are, when both come
+ * from the same distribution.
+ *
+ * The normal approximation is used, with the tie and continuity
+ * corrections. It's accurate enough from about 8 samples on each side
+ * -- i.e. from 8 epochs.
+ * @return The p-value, 1 if a side is empty.
+ * @throw std::bad_alloc if memory is exhausted.
+ */
+inline double mann_whitney_greater(std::vector<double> const& a, std::vector<double> const& b)
+{
+    std::size_t const n1 = a.size();
+    std::size_t const n2 = b.size();
+    if (n1 == 0 || n2 == 0) return 1;
+
+    // (value, from a?) sorted by value, ranks averaged among ties
+    std::vector<std::pair<double, bool>> all;
+    all.reserve(n1 + n2);
+    for (double const x : a) all.emplace_back(x, true);
+    for (double const x : b) all.emplace_back(x, false);
+    std::sort(all.begin(), all.end());
+
+    double            rank_sum_a = 0;
+    double            ties       = 0; // sum of t^3 - t
+    std::size_t const n          = all.size();
+    for (std::size_t i = 0; i < n;) {
+        std::size_t j = i;
+        while (j < n && all[j].first == all[i].first) ++j;
+        double const t    = double(j - i);
+        double const rank = (double(i + 1) + double(j)) / 2;
+        for (std::size_t k = i; k < j; ++k) {
+            if (all[k].second) rank_sum_a += rank;
+        }
+        ties += t * t * t - t;
+        i = j;
+    }
+
+    double const u    = rank_sum_a - double(n1) * double(n1 + 1) / 2;
+    double const mean = double(n1) * double(n2) / 2;
+    double const var  = double(n1) * double(n2) / 12
+                      * (double(n + 1) - ties / (double(n) * double(n - 1)));
+    if (var <= 0) return 1;
+    double const z = (u - mean - 0.5) / std::sqrt(var);
+    return 0.5 * std::erfc(z / std::sqrt(2.0));
+}
+
+/** Comparison of a result to its baseline. */
+struct baseline_comparison
+{
+    double ratio;      ///< Current median elapsed time / baseline one
+    double p_value;    ///< Of the current samples being slower, see `mann_whitney_greater()`
+    bool   regression; ///< Significantly slower, by more than the threshold
+};
+
+/**
+ * Results of a previous run, to compare new results to.
+ *
+ * Results are matched by benchmark title, result name, and the values of
+ * the `keys` context variables -- e.g. "cache", for warm and cold
+ * results to be compared to their own baseline. Only the elapsed times
+ * of the baseline are kept in memory.
+ *
+ * A result regresses when its elapsed times are significantly greater
+ * -- Mann-Whitney U test at the `alpha` level -- and its median is
+ * greater by more than `threshold`.
+ */
+class BenchBaseline
+{
+public:
+    /**
+     * Constructor.
+     * @param[in] threshold  Relative slowdown tolerated, e.g. 0.05.
+     * @param[in] alpha      Significance level of the test.
+     * @param[in] keys       Context variables that distinguish results
+     *                       with the same title and name.
+     * @throw std::bad_alloc if memory is exhausted.
+     */
+    explicit BenchBaseline(
+            double threshold = 0.05, double alpha = 0.01, std::vector<std::string> keys = {"cache"})
+    : m_threshold(threshold)
+    , m_alpha(alpha)
+    , m_keys(std::move(keys))
+    {}
+
+    /**
+     * Reads the results of `filename`, a JSON Lines sidecar.
+     * @throw std::runtime_error if the file cannot be read, or is
+     *        malformed.
+     */
+    void load(std::string const& filename)
+    {
+        SidecarReader  in(filename);
+        sidecar_result r;
+        while (in.next(r)) {
+            std::string k = r.title + '\n' + r.name;
+            for (auto const& name : m_keys) {
+                auto const it = r.context.find(name);
+                k += '\n' + (it != r.context.end() ? it->second : std::string());
+            }
+            // Sidecars hold times per iteration: they're compared per unit,
+            // whatever the batch of each run
+            auto& elapsed = r.epochs["elapsed"];
+            std::erase_if(elapsed, [](double x) { return !std::isfinite(x); });
+            for (auto& x : elapsed) x /= r.batch;
+            m_results[std::move(k)] = std::move(elapsed);
+        }
+    }
+
+    /** Number of baseline results. */
+    [[nodiscard]] std::size_t size() const noexcept { return m_results.size(); }
+    [[nodiscard]] double threshold() const noexcept { return m_threshold; }
+
+    /**
+     * Elapsed times per unit of the baseline of `r`, a result of the
+     * benchmark titled `title`.
+     * @return nullptr if there is no such baseline.
+     */
+    [[nodiscard]]
+    std::vector<double> const* find(std::string const& title, ankerl::nanobench::Result const& r) const
+    {
+        std::string k = title + '\n' + r.config().mBenchmarkName;
+        for (auto const& name : m_keys) {
+            std::string value;
+            try {
+                value = r.context(name);
+            } catch (std::exception const&) {
+                // Variable not set for this result
+            }
+            k += '\n' + value;
+        }
+        auto const it = m_results.find(k);
+        return it != m_results.end() ? &it->second : nullptr;
+    }
+
+    /**
+     * Compares `r` to its baseline `base`, elapsed times per unit.
+     * @throw std::bad_alloc if memory is exhausted.
+     */
+    [[nodiscard]]
+    baseline_comparison compare(ankerl::nanobench::Result const& r, std::vector<double> const& base) const
+    {
+        using Measure = ankerl::nanobench::Result::Measure;
+        double const        batch = r.config().mBatch;
+        std::vector<double> current;
+        for (std::size_t i = 0; i < r.size(); ++i) current.push_back(r.get(i, Measure::elapsed) / batch);
+
+        std::vector<double> sorted = base;
+        std::sort(sorted.begin(), sorted.end());
+        double const base_median = sorted.empty() ? 0
+            : sorted.size() % 2 ? sorted[sorted.size() / 2]
+                                : (sorted[sorted.size() / 2 - 1] + sorted[sorted.size() / 2]) / 2;
+        double const ratio   = base_median > 0 ? r.median(Measure::elapsed) / batch / base_median : 1;
+        double const p_value = mann_whitney_greater(current, base);
+        return {ratio, p_value, p_value < m_alpha && ratio > 1 + m_threshold};
+    }
+
+private:
+    double                                     m_threshold;
+    double                                     m_alpha;
+    std::vector<std::string>                   m_keys;
+    std::map<std::string, std::vector<double>> m_results;
+};
+
+#endif // bench_baseline_hpp
@@ -0,0 +1,367 @@
+// Benchmark environment checks and host fingerprint.
+// ======================================================================
+// Copyright (c) 2025 CS GROUP
+//
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// ======================================================================
+//
+// Authors:
+// - Luc Hermitte, initial author
+//
+// ======================================================================
+//
+// Defines:
+// - environment_check: one setting that disturbs measurements.
+// - BenchEnvironment: checks of the CPU frequency governor, turbo,
+//   SMT siblings, ASLR and isolated cores, and the host fingerprint to
+//   embed in reports.
+
+#ifndef bench_environment_hpp
+#define bench_environment_hpp
+
+#include "cache_topology.hpp"
+#include "cpu_affinity.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if __has_include(<sys/utsname.h>)
+#  include <sys/utsname.h>
+#endif
+
+/** Outcome of one `BenchEnvironment` check. */
+struct environment_check
+{
+    std::string name;   ///< e.g. "governor"
+    std::string value;  ///< e.g. "powersave", or "unknown"
+    bool        ok;     ///< False when the setting disturbs measurements
+    std::string advice; ///< How to fix it, when not ok
+};
+
+/**
+ * Settings of the host that make measurements noisy or biased, and its
+ * fingerprint.
+ *
+ * Checks, from Linux sysfs and procfs:
+ * - "governor": every checked core uses the `performance` governor;
+ * - "turbo": turbo/boost is disabled;
+ * - "smt": the SMT siblings of the pinned core are idle;
+ * - "aslr": address space layout randomization is disabled;
+ * - "isolcpus": the pinned core is isolated from the scheduler.
+ *
+ * What cannot be read -- e.g. no cpufreq in a VM -- is reported as
+ * "unknown", and isn't considered as an issue.
+ *
+ * The fingerprint tells what the results depend on: CPU model,
+ * microcode, kernel, compiler and its flags, and cache sizes. The flags
+ * are known when the build defines `NANOBENCH_VIOLIN_CXXFLAGS`, as the
+ * Makefile of the examples does.
+ */
+class BenchEnvironment
+{
+public:
+    using fields = std::vector<std::pair<std::string, std::string>>;
+
+    /**
+     * Runs the checks, and collects the fingerprint.
+     * @param[in] cpu  Core the benchmarks are pinned to, -1 if they
+     *                 aren't: the allowed cores are checked.
+     * @throw std::bad_alloc if memory is exhausted. Unlikely.
+     * @note The SMT check samples the load of the siblings for 200 ms.
+     */
+    [[nodiscard]]
+    static BenchEnvironment detect(int cpu = -1)
+    {
+        BenchEnvironment env;
+        std::vector<int> const cpus = cpu < 0 ? allowed_cpus() : std::vector<int>{cpu};
+        env.check_governor(cpus);
+        env.check_turbo();
+        env.check_smt(cpu);
+        env.check_aslr();
+        env.check_isolation(cpu);
+        env.collect_fingerprint(cpu);
+        return env;
+    }
+
+    [[nodiscard]] std::vector<environment_check> const& checks() const noexcept { return m_checks; }
+
+    /** Fingerprint, in display order: "cpu", "microcode", "kernel"... */
+    [[nodiscard]] fields const& fingerprint() const noexcept { return m_fingerprint; }
+
+    /** Whether no check has failed. */
+    [[nodiscard]]
+    bool ok() const noexcept
+    {
+        return std::all_of(m_checks.begin(), m_checks.end(), [](auto const& c) { return c.ok; });
+    }
+
+    /** Fingerprint and check values, e.g. for `BenchSidecar::metadata()`. */
+    [[nodiscard]]
+    fields all_fields() const
+    {
+        fields res = m_fingerprint;
+        for (auto const& c : m_checks) res.emplace_back(c.name, c.value);
+        return res;
+    }
+
+    /**
+     * HTML table of the fingerprint and the checks, the failed ones in
+     * red.
+     * @throw std::bad_alloc if memory is exhausted.
+     */
+    [[nodiscard]]
+    std::string html() const
+    {
+        std::string out =
+            "    <details>\n"
+            "      <summary>Environment" + std::string(ok() ? "" : " <span style=\"color: red\">(unreliable)</span>")
+            + "</summary>\n"
+            "      <table style=\"font-family: sans-serif; font-size: small\">\n";
+        for (auto const& [key, value] : m_fingerprint) {
+            out += "        <tr><th align=\"left\">" + escape(key) + "</th><td>" + escape(value) + "</td></tr>\n";
+        }
+        for (auto const& c : m_checks) {
+            out += "        <tr><th align=\"left\">" + escape(c.name) + "</th><td"
+                + (c.ok ? ">" + escape(c.value) : " style=\"color: red\">" + escape(c.value) + " -- " + escape(c.advice))
+                + "</td></tr>\n";
+        }
+        return out + "      </table>\n    </details>\n";
+    }
+
+    /**
+     * Parses a Linux CPU list, like "0-3,8".
+     * @throw std::bad_alloc if memory is exhausted. Unlikely.
+     */
+    static std::vector<int> parse_cpu_list(std::string const& list)
+    {
+        std::vector<int>  cpus;
+        std::stringstream in(list);
+        std::string       range;
+        while (std::getline(in, range, ',')) {
+            if (range.empty() || range.find_first_not_of(" \n") == std::string::npos) continue;
+            try {
+                auto const dash  = range.find('-');
+                int const  first = std::stoi(range.substr(0, dash));
+                int const  last  = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+                for (int c = first; c <= last; ++c) cpus.push_back(c);
+            } catch (std::exception const&) {
+                // Ignore what isn't a range
+            }
+        }
+        return cpus;
+    }
+
+private:
+    static std::string read_line(std::string const& filename)
+    {
+        std::ifstream in(filename);
+        std::string   line;
+        std::getline(in, line);
+        return line;
+    }
+
+    static std::string cpu_dir(int cpu)
+    {
+        return "/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/";
+    }
+
+    static std::string escape(std::string const& s)
+    {
+        std::string out;
+        for (char const c : s) {
+            switch (c) {
+                case '<': out += "&lt;"; break;
+                case '>': out += "&gt;"; break;
+                case '&': out += "&amp;"; break;
+                default:  out += c;
+            }
+        }
+        return out;
+    }
+
+    void check_governor(std::vector<int> const& cpus)
+    {
+        std::vector<std::string> governors;
+        for (int const cpu : cpus) {
+            std::string const g = read_line(cpu_dir(cpu) + "cpufreq/scaling_governor");
+            if (!g.empty() && std::find(governors.begin(), governors.end(), g) == governors.end()) {
+                governors.push_back(g);
+            }
+        }
+        std::string value;
+        for (auto const& g : governors) value += (value.empty() ? "" : ", ") + g;
+        bool const ok = governors.empty() || (governors.size() == 1 && governors.front() == "performance");
+        m_checks.push_back({"governor", value.empty() ? "unknown" : value, ok,
+                "cpupower frequency-set -g performance"});
+    }
+
+    void check_turbo()
+    {
+        // intel_pstate, or acpi-cpufreq and amd-pstate
+        std::string const no_turbo = read_line("/sys/devices/system/cpu/intel_pstate/no_turbo");
+        std::string const boost    = read_line("/sys/devices/system/cpu/cpufreq/boost");
+        std::string       value    = "unknown";
+        if (!no_turbo.empty()) {
+            value = no_turbo == "1" ? "off" : "on";
+        } else if (!boost.empty()) {
+            value = boost == "0" ? "off" : "on";
+        }
+        m_checks.push_back({"turbo", value, value != "on",
+                !no_turbo.empty() ? "echo 1 > /sys/devices/system/cpu/intel_pstate/no_turbo"
+                                  : "echo 0 > /sys/devices/system/cpu/cpufreq/boost"});
+    }
+
+    /** Busy and total jiffies of each core, from /proc/stat. */
+    static std::vector<std::pair<unsigned long long, unsigned long long>> cpu_times()
+    {
+        std::vector<std::pair<unsigned long long, unsigned long long>> times;
+        std::ifstream stat("/proc/stat");
+        std::string   line;
+        while (std::getline(stat, line)) {
+            if (line.rfind("cpu", 0) != 0 || line.size() < 4 || line[3] == ' ') continue;
+            std::istringstream in(line.substr(3));
+            std::size_t        cpu   = 0;
+            unsigned long long total = 0, idle = 0, v = 0;
+            in >> cpu;
+            for (int field = 0; in >> v; ++field) {
+                total += v;
+                if (field == 3 || field == 4) idle += v; // idle, iowait
+            }
+            if (times.size() <= cpu) times.resize(cpu + 1);
+            times[cpu] = {total - idle, total};
+        }
+        return times;
+    }
+
+    void check_smt(int cpu)
+    {
+        std::string const active = read_line("/sys/devices/system/cpu/smt/active");
+        if (cpu < 0 || active != "1") {
+            m_checks.push_back({"smt", active.empty() ? "unknown" : active == "1" ? "on" : "off", true, ""});
+            return;
+        }
+        std::vector<int> siblings = parse_cpu_list(read_line(cpu_dir(cpu) + "topology/thread_siblings_list"));
+        std::erase(siblings, cpu);
+        if (siblings.empty()) {
+            m_checks.push_back({"smt", "on, no sibling", true, ""});
+            return;
+        }
+        auto const before = cpu_times();
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        auto const  after   = cpu_times();
+        double      busiest = 0;
+        std::string value   = "on, siblings:";
+        for (int const s : siblings) {
+            value += " " + std::to_string(s);
+            auto const i = std::size_t(s);
+            if (i >= before.size() || i >= after.size()) continue;
+            auto const total = after[i].second - before[i].second;
+            if (total > 0) busiest = std::max(busiest, double(after[i].first - before[i].first) / double(total));
+        }
+        value += " (" + std::to_string(int(busiest * 100)) + "% busy)";
+        m_checks.push_back({"smt", value, busiest < 0.1,
+                "pin to an idle core, or echo off > /sys/devices/system/cpu/smt/control"});
+    }
+
+    void check_aslr()
+    {
+        std::string const v = read_line("/proc/sys/kernel/randomize_va_space");
+        m_checks.push_back({"aslr", v.empty() ? "unknown" : v == "0" ? "off" : "on", v.empty() || v == "0",
+                "run with setarch -R, or echo 0 > /proc/sys/kernel/randomize_va_space"});
+    }
+
+    void check_isolation(int cpu)
+    {
+        std::string const      list     = read_line("/sys/devices/system/cpu/isolated");
+        std::vector<int> const isolated = parse_cpu_list(list);
+        std::string const      value    = list.empty() ? "none" : list;
+        if (cpu < 0) {
+            m_checks.push_back({"isolcpus", value, true, ""});
+            return;
+        }
+        bool const ok = std::find(isolated.begin(), isolated.end(), cpu) != isolated.end();
+        m_checks.push_back({"isolcpus", value + (ok ? ", cpu " : ", not cpu ") + std::to_string(cpu), ok,
+                "boot with isolcpus=" + std::to_string(cpu) + ", or pin to an isolated core"});
+    }
+
+    void collect_fingerprint(int cpu)
+    {
+        std::string   model = "unknown", microcode = "unknown";
+        std::ifstream cpuinfo("/proc/cpuinfo");
+        std::string   line;
+        auto const    value_of = [&line] {
+            auto const colon = line.find(':');
+            auto const first = colon == std::string::npos ? colon : line.find_first_not_of(' ', colon + 1);
+            return first == std::string::npos ? std::string() : line.substr(first);
+        };
+        while (std::getline(cpuinfo, line) && (model == "unknown" || microcode == "unknown")) {
+            if (line.rfind("model name", 0) == 0) model = value_of();
+            if (line.rfind("microcode", 0) == 0) microcode = value_of();
+        }
+        m_fingerprint.emplace_back("cpu", model);
+        m_fingerprint.emplace_back("microcode", microcode);
+
+        std::string kernel = "unknown";
+#if __has_include(<sys/utsname.h>)
+        struct utsname name;
+        if (::uname(&name) == 0) {
+            kernel = std::string(name.sysname) + " " + name.release + " " + name.version + " " + name.machine;
+        }
+#endif
+        m_fingerprint.emplace_back("kernel", kernel);
+
+#if defined(__clang__)
+        m_fingerprint.emplace_back("compiler", "clang " __clang_version__);
+#elif defined(__GNUC__)
+        m_fingerprint.emplace_back("compiler", "gcc " __VERSION__);
+#else
+        m_fingerprint.emplace_back("compiler", "unknown");
+#endif
+#if defined(NANOBENCH_VIOLIN_CXXFLAGS)
+        m_fingerprint.emplace_back("cxxflags", NANOBENCH_VIOLIN_CXXFLAGS);
+#else
+        m_fingerprint.emplace_back("cxxflags", "unknown");
+#endif
+
+        std::string         caches;
+        CacheTopology const topology = CacheTopology::detect();
+        for (auto const& l : topology.levels()) {
+            caches += (caches.empty() ? "L" : ", L") + std::to_string(l.number) + " " + human_bytes(l.size);
+        }
+        m_fingerprint.emplace_back("caches", caches.empty() ? "unknown" : caches);
+        m_fingerprint.emplace_back("pinned", cpu < 0 ? "no" : "cpu " + std::to_string(cpu));
+    }
+
+    std::vector<environment_check> m_checks;
+    fields                         m_fingerprint;
+};
+
+#endif // bench_environment_hpp
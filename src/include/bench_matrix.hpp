@@ -0,0 +1,290 @@
+// Benchmark matrices over types x operations x sizes.
+// ======================================================================
+// Copyright (c) 2025 CS GROUP
+//
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// ======================================================================
+//
+// Authors:
+// - Luc Hermitte, initial author
+//
+// ======================================================================
+//
+// Defines:
+// - type_list, op_list: compile-time lists of the matrix axes.
+// - matrix_type_name: display names of the types.
+// - op_add, op_sub, op_mul, op_div: common binary operations.
+// - BenchMatrix: instantiates and runs one kernel per combination,
+//   grouped into one Bench per type, operation, or size.
+
+#ifndef bench_matrix_hpp
+#define bench_matrix_hpp
+
+#include "nanobench_html_graph_renderer.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+template <typename... Ts>
+struct type_list {};
+
+template <typename... Ops>
+struct op_list {};
+
+/**
+ * Display name of the types of a `BenchMatrix`.
+ * Specialize it for other types.
+ */
+template <typename T>
+struct matrix_type_name;
+
+#define NANOBENCH_MATRIX_TYPE_NAME(type, text) \
+    template <>                                \
+    struct matrix_type_name<type>              \
+    {                                          \
+        static constexpr char const* value = text; \
+    }
+
+NANOBENCH_MATRIX_TYPE_NAME(float, "float");
+NANOBENCH_MATRIX_TYPE_NAME(double, "double");
+NANOBENCH_MATRIX_TYPE_NAME(long double, "long double");
+NANOBENCH_MATRIX_TYPE_NAME(std::int8_t, "int8");
+NANOBENCH_MATRIX_TYPE_NAME(std::int16_t, "int16");
+NANOBENCH_MATRIX_TYPE_NAME(std::int32_t, "int32");
+NANOBENCH_MATRIX_TYPE_NAME(std::int64_t, "int64");
+NANOBENCH_MATRIX_TYPE_NAME(std::uint8_t, "uint8");
+NANOBENCH_MATRIX_TYPE_NAME(std::uint16_t, "uint16");
+NANOBENCH_MATRIX_TYPE_NAME(std::uint32_t, "uint32");
+NANOBENCH_MATRIX_TYPE_NAME(std::uint64_t, "uint64");
+
+/**
+ * Binary operations for `op_list`.
+ * Any stateless function object with a static `name` does.
+ */
+struct op_add
+{
+    static constexpr char const* name = "+";
+    constexpr auto operator()(auto l, auto r) const noexcept { return l + r; }
+};
+struct op_sub
+{
+    static constexpr char const* name = "-";
+    constexpr auto operator()(auto l, auto r) const noexcept { return l - r; }
+};
+struct op_mul
+{
+    static constexpr char const* name = "*";
+    constexpr auto operator()(auto l, auto r) const noexcept { return l * r; }
+};
+struct op_div
+{
+    static constexpr char const* name = "/";
+    constexpr auto operator()(auto l, auto r) const noexcept { return l / r; }
+};
+
+/** Size of a `BenchMatrix` working set, and how to name it. */
+struct matrix_size
+{
+    std::string label; ///< e.g. "L1"
+    std::size_t bytes;
+};
+
+/** Axis of a `BenchMatrix` that gets one `Bench` per value. */
+enum class MatrixGroup
+{
+    type,
+    op,
+    size,
+};
+
+template <typename Types, typename Ops>
+class BenchMatrix;
+
+/**
+ * Runs one benchmark per combination of types, operations, and sizes.
+ *
+ * The kernel is a generic callable whose `operator()` is a template on
+ * the element type and the operation:
+ *
+ * ```c++
+ * BenchMatrix<type_list<float, double>, op_list<op_div, op_mul>> matrix(
+ *         "mult/div", {{"L1", avail_L1}, {"L2", avail_L2}});
+ * matrix.run(
+ *     []<typename T, typename Op>(ankerl::nanobench::Bench& b, std::string const& name, std::size_t bytes) {
+ *         bench_arite2<T>(b, name.c_str(), bytes, [](auto x, auto y, auto z) { compute(x, y, z, Op{}); });
+ *     },
+ *     [](ankerl::nanobench::Bench const& b, std::string const& title) { render_graph(b, title); });
+ * ```
+ *
+ * Each (type, operation) pair instantiates its own kernel: the operation
+ * is known at compile time and inlined, no `std::function` nor indirect
+ * call is left in the timed loop. Sizes are runtime values as they
+ * usually come from `CacheTopology`.
+ *
+ * Combinations are grouped into one `Bench` per type -- by default --,
+ * per operation, or per size. Within a group, results are named after
+ * the other axes, e.g. "/ L1".
+ */
+template <typename... Ts, typename... Ops>
+class BenchMatrix<type_list<Ts...>, op_list<Ops...>>
+{
+public:
+    /**
+     * Constructor.
+     * @param[in] title  Prefix of the titles of the groups.
+     * @param[in] sizes  Sizes axis.
+     * @param[in] group  Axis that gets one `Bench` per value.
+     * @throw std::bad_alloc if memory is exhausted.
+     */
+    BenchMatrix(std::string title, std::vector<matrix_size> sizes, MatrixGroup group = MatrixGroup::type)
+    : m_title(std::move(title))
+    , m_sizes(std::move(sizes))
+    , m_group(group)
+    {}
+
+    /**
+     * Sets how each group `Bench` is configured: epochs, unit...
+     * @return *this
+     */
+    BenchMatrix& configure(std::function<void(ankerl::nanobench::Bench&)> configure)
+    {
+        m_configure = std::move(configure);
+        return *this;
+    }
+
+    /**
+     * Runs every combination.
+     * @tparam Kernel   Generic callable, see the class documentation.
+     * @tparam OnGroup  Callable taking `(ankerl::nanobench::Bench const&, std::string const& title)`
+     *                  called once each group has been run, typically
+     *                  to render it.
+     * @throw Whatever `kernel` or `on_group` may throw.
+     */
+    template <typename Kernel, typename OnGroup>
+    void run(Kernel&& kernel, OnGroup&& on_group) const
+    {
+        using kernel_type = std::remove_reference_t<Kernel>;
+        std::vector<cell<kernel_type>> cells;
+        std::size_t                    type_index = 0;
+        (add_cells<kernel_type, Ts>(cells, type_index++), ...);
+
+        std::stable_sort(cells.begin(), cells.end(), [this](auto const& l, auto const& r) {
+            return group_of(l) < group_of(r);
+        });
+
+        for (auto first = cells.begin(); first != cells.end();) {
+            auto const last = std::find_if(first, cells.end(), [&](auto const& c) {
+                return group_of(c) != group_of(*first);
+            });
+            ankerl::nanobench::Bench b;
+            if (m_configure) m_configure(b);
+            std::string const title = m_title + " " + group_label(*first);
+            b.title(title);
+            for (auto c = first; c != last; ++c) {
+                c->run(kernel, b, result_name(*c), m_sizes[c->size].bytes);
+            }
+            on_group(std::as_const(b), title);
+            first = last;
+        }
+    }
+
+private:
+    template <typename Kernel>
+    struct cell
+    {
+        std::size_t type;
+        std::size_t op;
+        std::size_t size;
+        char const* type_name;
+        char const* op_name;
+        void (*run)(Kernel&, ankerl::nanobench::Bench&, std::string const&, std::size_t);
+    };
+
+    template <typename Kernel, typename T>
+    void add_cells(std::vector<cell<Kernel>>& cells, std::size_t type_index) const
+    {
+        std::size_t op_index = 0;
+        (add_op_cells<Kernel, T, Ops>(cells, type_index, op_index++), ...);
+    }
+
+    template <typename Kernel, typename T, typename Op>
+    void add_op_cells(std::vector<cell<Kernel>>& cells, std::size_t type_index, std::size_t op_index) const
+    {
+        for (std::size_t s = 0; s < m_sizes.size(); ++s) {
+            cells.push_back({
+                type_index, op_index, s, matrix_type_name<T>::value, Op::name,
+                [](Kernel& k, ankerl::nanobench::Bench& b, std::string const& name, std::size_t bytes) {
+                    k.template operator()<T, Op>(b, name, bytes);
+                }});
+        }
+    }
+
+    template <typename Cell>
+    std::size_t group_of(Cell const& c) const noexcept
+    {
+        switch (m_group) {
+            case MatrixGroup::type: return c.type;
+            case MatrixGroup::op:   return c.op;
+            case MatrixGroup::size: return c.size;
+        }
+        return 0;
+    }
+
+    template <typename Cell>
+    std::string group_label(Cell const& c) const
+    {
+        switch (m_group) {
+            case MatrixGroup::type: return c.type_name;
+            case MatrixGroup::op:   return c.op_name;
+            case MatrixGroup::size: return m_sizes[c.size].label;
+        }
+        return "";
+    }
+
+    /// Name after the axes that aren't grouped -- and that have more than one value.
+    template <typename Cell>
+    std::string result_name(Cell const& c) const
+    {
+        std::string res;
+        auto const  append = [&res](std::string const& s) {
+            if (!res.empty()) res += ' ';
+            res += s;
+        };
+        if (m_group != MatrixGroup::type && sizeof...(Ts) > 1) append(c.type_name);
+        if (m_group != MatrixGroup::op) append(c.op_name);
+        if (m_group != MatrixGroup::size) append(m_sizes[c.size].label);
+        return res;
+    }
+
+    std::string                                     m_title;
+    std::vector<matrix_size>                        m_sizes;
+    MatrixGroup                                     m_group;
+    std::function<void(ankerl::nanobench::Bench&)> m_configure;
+};
+
+#endif // bench_matrix_hpp
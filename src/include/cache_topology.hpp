@@ -0,0 +1,222 @@
+// Runtime detection of the CPU cache hierarchy.
+// ======================================================================
+// Copyright (c) 2025 CS GROUP
+//
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// ======================================================================
+//
+// Authors:
+// - Luc Hermitte, initial author
+//
+// ======================================================================
+//
+// Defines:
+// - CacheTopology: data and unified cache levels seen by the current
+//   CPU, detected at runtime.
+// - human_bytes(): formatting helper for cache and working-set sizes.
+
+#ifndef cache_topology_hpp
+#define cache_topology_hpp
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#if __has_include(<unistd.h>)
+#  include <unistd.h>
+#endif
+
+/**
+ * Returns `bytes` in a human readable form: "48 KiB", "2 MiB"...
+ * @throw std::bad_alloc if the string cannot be created. Unlikely.
+ */
+inline std::string human_bytes(std::size_t bytes)
+{
+    static char const* const units[] = {"B", "KiB", "MiB", "GiB", "TiB"};
+    std::size_t              u       = 0;
+    double                   value   = double(bytes);
+    while (value >= 1024 && u + 1 < std::size(units)) {
+        value /= 1024;
+        ++u;
+    }
+    std::string res = std::to_string(value);
+    // Keep at most one decimal, and none when it's 0
+    res.erase(res.find('.') + 2);
+    if (res.back() == '0') res.erase(res.size() - 2);
+    return res + " " + units[u];
+}
+
+/**
+ * Data cache hierarchy of the CPU the program runs on.
+ *
+ * Unlike `getconf` values injected at compile time, the topology is
+ * detected when the program runs: a binary built on one host stays
+ * correct on another.
+ *
+ * On Linux, the information comes from
+ * `/sys/devices/system/cpu/cpu0/cache/`. `sysconf()` is used as a
+ * fallback.
+ */
+class CacheTopology
+{
+public:
+    struct level
+    {
+        unsigned    number;    ///< 1 for L1, 2 for L2...
+        std::size_t size;      ///< In bytes
+        std::size_t line_size; ///< In bytes
+    };
+
+    /**
+     * Detects the data and unified cache levels.
+     * @return The topology -- which may be empty if nothing could be
+     *         detected.
+     * @throw std::bad_alloc if memory is exhausted. Unlikely.
+     */
+    [[nodiscard]]
+    static CacheTopology detect()
+    {
+        CacheTopology res;
+        res.detect_from_sysfs();
+        if (res.m_levels.empty()) res.detect_from_sysconf();
+        std::sort(res.m_levels.begin(), res.m_levels.end(), [](level const& l, level const& r) {
+            return l.number < r.number;
+        });
+        return res;
+    }
+
+    /** Detected levels, sorted from L1 to the last level. */
+    [[nodiscard]]
+    std::vector<level> const& levels() const noexcept { return m_levels; }
+
+    /**
+     * Size of the cache of level `number`.
+     * @return 0 if there is no such level.
+     */
+    [[nodiscard]]
+    std::size_t size(unsigned number) const noexcept
+    {
+        for (auto const& l : m_levels) {
+            if (l.number == number) return l.size;
+        }
+        return 0;
+    }
+
+    /** Size of the last level cache, 0 if nothing has been detected. */
+    [[nodiscard]]
+    std::size_t last_level_size() const noexcept
+    {
+        return m_levels.empty() ? 0 : m_levels.back().size;
+    }
+
+    /**
+     * Size of the cache of level `number`, or a typical size if there is
+     * no such level: 32 KiB for L1, 1 MiB for L2, 8 MiB beyond.
+     */
+    [[nodiscard]]
+    std::size_t size_or_default(unsigned number) const noexcept
+    {
+        std::size_t const res = size(number);
+        if (res != 0) return res;
+        return number <= 1 ? std::size_t(32) << 10 : number == 2 ? std::size_t(1) << 20 : std::size_t(8) << 20;
+    }
+
+    /** Size of the last level cache, 8 MiB if nothing has been detected. */
+    [[nodiscard]]
+    std::size_t last_level_size_or_default() const noexcept
+    {
+        return m_levels.empty() ? std::size_t(8) << 20 : m_levels.back().size;
+    }
+
+    /** Cache line size of L1, 64 if nothing has been detected. */
+    [[nodiscard]]
+    std::size_t line_size() const noexcept
+    {
+        return m_levels.empty() ? 64 : m_levels.front().line_size;
+    }
+
+private:
+    static std::size_t parse_size(std::string const& s)
+    {
+        std::size_t pos   = 0;
+        std::size_t value = std::stoul(s, &pos);
+        if (pos < s.size()) {
+            switch (s[pos]) {
+                case 'K': value <<= 10; break;
+                case 'M': value <<= 20; break;
+                case 'G': value <<= 30; break;
+            }
+        }
+        return value;
+    }
+
+    void detect_from_sysfs()
+    {
+        std::string const root = "/sys/devices/system/cpu/cpu0/cache/index";
+        for (unsigned index = 0;; ++index) {
+            std::string const dir = root + std::to_string(index) + "/";
+            std::ifstream     level_f(dir + "level");
+            std::ifstream     type_f(dir + "type");
+            std::ifstream     size_f(dir + "size");
+            std::ifstream     line_f(dir + "coherency_line_size");
+            unsigned          number = 0;
+            std::string       type, size;
+            std::size_t       line = 64;
+            if (!(level_f >> number) || !(type_f >> type) || !(size_f >> size)) break;
+            line_f >> line;
+            if (type == "Instruction") continue;
+            try {
+                m_levels.push_back({number, parse_size(size), line});
+            } catch (std::exception const&) {
+                // Ignore unexpected formats
+            }
+        }
+    }
+
+    void detect_from_sysconf()
+    {
+#if defined(_SC_LEVEL1_DCACHE_SIZE)
+        struct { unsigned number; int size; int line; } const queries[] = {
+            {1, _SC_LEVEL1_DCACHE_SIZE, _SC_LEVEL1_DCACHE_LINESIZE},
+            {2, _SC_LEVEL2_CACHE_SIZE, _SC_LEVEL2_CACHE_LINESIZE},
+            {3, _SC_LEVEL3_CACHE_SIZE, _SC_LEVEL3_CACHE_LINESIZE},
+            {4, _SC_LEVEL4_CACHE_SIZE, _SC_LEVEL4_CACHE_LINESIZE},
+        };
+        for (auto const& q : queries) {
+            long const size = ::sysconf(q.size);
+            long const line = ::sysconf(q.line);
+            if (size > 0) {
+                m_levels.push_back({q.number, std::size_t(size), line > 0 ? std::size_t(line) : 64});
+            }
+        }
+#endif
+    }
+
+    std::vector<level> m_levels;
+};
+
+#endif // cache_topology_hpp
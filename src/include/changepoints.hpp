@@ -0,0 +1,138 @@
+// Changepoints and rolling medians of epoch-ordered samples.
+// ======================================================================
+// Copyright (c) 2025 CS GROUP
+//
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// ======================================================================
+//
+// Authors:
+// - Luc Hermitte, initial author
+//
+// ======================================================================
+//
+// Defines:
+// - pettitt_test(): most likely shift of a series, and its p-value.
+// - changepoints(): epochs where the distribution of a series shifts.
+// - rolling_median(): centered rolling median of a series.
+
+#ifndef changepoints_hpp
+#define changepoints_hpp
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <span>
+#include <utility>
+#include <vector>
+
+/**
+ * Pettitt's test: rank-based test of a single shift in `x`.
+ *
+ * As the Mann-Whitney U test it derives from, it doesn't assume the
+ * samples are normal: a few outliers, common with timings, don't make
+ * a change.
+ * @param[in] min_segment  Minimum number of samples on each side.
+ * @return The index of the first sample after the most likely shift,
+ *         and the approximate p-value of this shift -- 1 if `x` is too
+ *         short.
+ */
+inline std::pair<std::size_t, double> pettitt_test(std::span<double const> x, std::size_t min_segment = 3)
+{
+    std::size_t const n = x.size();
+    if (min_segment == 0 || n < 2 * min_segment) return {0, 1};
+
+    // U(t) = sum over i <= t < j of sign(x[j] - x[i]), computed
+    // incrementally: U(t) = U(t-1) - sum over j of sign(x[t] - x[j])
+    long long   u     = 0;
+    long long   best  = 0;
+    std::size_t where = 0;
+    for (std::size_t t = 0; t + min_segment < n; ++t) {
+        for (std::size_t j = 0; j < n; ++j) {
+            u -= (x[t] > x[j]) - (x[t] < x[j]);
+        }
+        if (t + 1 >= min_segment && std::llabs(u) > best) {
+            best  = std::llabs(u);
+            where = t + 1;
+        }
+    }
+    double const k  = double(best);
+    double const nd = double(n);
+    double const p  = std::min(1.0, 2 * std::exp(-6 * k * k / (nd * nd * nd + nd * nd)));
+    return {where, p};
+}
+
+/**
+ * Epochs where the distribution of `x` shifts, by binary segmentation:
+ * the series is split at each significant shift found by
+ * `pettitt_test()`, and each part is searched again.
+ *
+ * Typical causes are a warmup too short -- a shift in the first epochs
+ * --, frequency scaling, or thermal throttling.
+ * @param[in] alpha        Significance level of each test.
+ * @param[in] min_segment  Minimum number of epochs between changes.
+ * @return Sorted indices of the first epoch of each new segment.
+ * @throw std::bad_alloc if memory is exhausted.
+ */
+inline std::vector<std::size_t> changepoints(
+        std::span<double const> x, double alpha = 0.01, std::size_t min_segment = 3)
+{
+    std::vector<std::size_t>                         res;
+    std::vector<std::pair<std::size_t, std::size_t>> todo{{0, x.size()}};
+    while (!todo.empty()) {
+        auto const [first, last] = todo.back();
+        todo.pop_back();
+        auto const [at, p] = pettitt_test(x.subspan(first, last - first), min_segment);
+        if (p >= alpha) continue;
+        res.push_back(first + at);
+        todo.emplace_back(first, first + at);
+        todo.emplace_back(first + at, last);
+    }
+    std::sort(res.begin(), res.end());
+    return res;
+}
+
+/**
+ * Centered rolling median of `x`, over `window` samples -- fewer at
+ * the ends.
+ * @throw std::bad_alloc if memory is exhausted.
+ */
+inline std::vector<double> rolling_median(std::span<double const> x, std::size_t window)
+{
+    std::vector<double> res;
+    std::vector<double> w;
+    std::size_t const   half = window / 2;
+    for (std::size_t i = 0; i < x.size(); ++i) {
+        std::size_t const first = i > half ? i - half : 0;
+        std::size_t const last  = std::min(x.size(), i + half + 1);
+        w.assign(x.begin() + std::ptrdiff_t(first), x.begin() + std::ptrdiff_t(last));
+        auto const mid = w.begin() + std::ptrdiff_t(w.size() / 2);
+        std::nth_element(w.begin(), mid, w.end());
+        double m = *mid;
+        if (w.size() % 2 == 0) m = (m + *std::max_element(w.begin(), mid)) / 2;
+        res.push_back(m);
+    }
+    return res;
+}
+
+#endif // changepoints_hpp
@@ -0,0 +1,144 @@
+// Cold-cache measurements.
+// ======================================================================
+// Copyright (c) 2025 CS GROUP
+//
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// ======================================================================
+//
+// Authors:
+// - Luc Hermitte, initial author
+//
+// ======================================================================
+//
+// Defines:
+// - CacheState: warm or cold cache measurements.
+// - ColdRing<T>: copies of a working set used in turn, so that each
+//   call of a benchmarked function finds its data out of the caches.
+
+#ifndef cold_cache_hpp
+#define cold_cache_hpp
+
+#include "cache_topology.hpp"
+#include "test_vector.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <span>
+
+/** Whether benchmarked data are in the caches, or not. */
+enum class CacheState { warm, cold };
+
+/** "warm" or "cold", e.g. as a `Bench::context()` value. */
+constexpr char const* cache_state_name(CacheState state) noexcept
+{
+    return state == CacheState::cold ? "cold" : "warm";
+}
+
+/**
+ * Copies of a working set, used in turn by `next()`.
+ *
+ * All the copies together are bigger than twice the last level cache:
+ * the copy a call works on has been evicted by the other ones since it
+ * was last used. Unlike a `clflush` or a sweep over a scratch buffer
+ * before each call, no eviction work is measured: the only overhead
+ * is moving to the next copy.
+ *
+ * Copies are separated by one page, so that the prefetchers don't
+ * bring the next copy while the current one is processed.
+ *
+ * ```c++
+ * ColdRing<float> xs(x, copies), ys(y, copies), zs(count, copies);
+ * bench.run("cold", [&]() { kernel(xs.next(), ys.next(), zs.next()); });
+ * ```
+ */
+template <typename T>
+class ColdRing
+{
+public:
+    /**
+     * Number of copies of a working set of `bytes_per_call` bytes
+     * needed to evict each one from the caches of `topology`.
+     * @throw None
+     */
+    [[nodiscard]]
+    static std::size_t copies_for(std::size_t bytes_per_call, CacheTopology const& topology) noexcept
+    {
+        // Conservative default when nothing could be detected
+        std::size_t llc = topology.last_level_size();
+        if (llc == 0) llc = std::size_t(32) << 20;
+        return std::max<std::size_t>(2, (2 * llc + bytes_per_call - 1) / std::max<std::size_t>(1, bytes_per_call) + 1);
+    }
+
+    /**
+     * Constructs `copies` copies of `data`.
+     * @throw std::bad_alloc if memory is exhausted.
+     * @pre `copies > 0`
+     */
+    ColdRing(std::span<T const> data, std::size_t copies)
+    : ColdRing(data.size(), copies)
+    {
+        for (std::size_t c = 0; c < copies; ++c) {
+            std::copy(data.begin(), data.end(), m_data.begin() + c * m_stride);
+        }
+    }
+
+    /**
+     * Constructs `copies` buffers of `count` value-initialized
+     * elements, e.g. for outputs.
+     * @throw std::bad_alloc if memory is exhausted.
+     * @pre `copies > 0`
+     */
+    ColdRing(std::size_t count, std::size_t copies)
+    : m_count(count)
+    , m_stride(stride(count))
+    , m_copies(copies)
+    , m_data(m_stride * copies)
+    {}
+
+    /** Next copy -- the first one after the last. */
+    [[nodiscard]]
+    std::span<T> next() noexcept
+    {
+        m_index = m_index + 1 == m_copies ? 0 : m_index + 1;
+        return {m_data.data() + m_index * m_stride, m_count};
+    }
+
+    [[nodiscard]] std::size_t copies() const noexcept { return m_copies; }
+
+private:
+    /// Elements between two copies: rounded to pages, plus a gap page.
+    static std::size_t stride(std::size_t count) noexcept
+    {
+        std::size_t const page  = PageArena::base_page_size();
+        std::size_t const bytes = (count * sizeof(T) + page - 1) / page * page + page;
+        return (bytes + sizeof(T) - 1) / sizeof(T);
+    }
+
+    std::size_t    m_count;
+    std::size_t    m_stride;
+    std::size_t    m_copies;
+    std::size_t    m_index = 0;
+    test_vector<T> m_data;
+};
+
+#endif // cold_cache_hpp
@@ -0,0 +1,100 @@
+// CPU affinity helpers.
+// ======================================================================
+// Copyright (c) 2025 CS GROUP
+//
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// ======================================================================
+//
+// Authors:
+// - Luc Hermitte, initial author
+//
+// ======================================================================
+//
+// Defines:
+// - allowed_cpus(): cores the process is allowed to run on.
+// - core_count(): number of cores to use, known or not.
+// - pin_to_cpu(): pins the calling thread to a core.
+
+#ifndef cpu_affinity_hpp
+#define cpu_affinity_hpp
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#if __has_include(<sched.h>)
+#  include <sched.h>
+#endif
+
+/**
+ * Cores the process is allowed to run on, as set by `taskset` or
+ * cgroups.
+ * @return The allowed cores -- empty if they cannot be queried: the
+ *         threads shall not be pinned then.
+ * @throw std::bad_alloc if memory is exhausted. Unlikely.
+ */
+inline std::vector<int> allowed_cpus()
+{
+    std::vector<int> cpus;
+#if defined(CPU_SETSIZE)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (::sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &set)) cpus.push_back(cpu);
+        }
+    }
+#endif
+    return cpus;
+}
+
+/**
+ * Number of cores in `cpus`, as returned by `allowed_cpus()`, or
+ * `std::thread::hardware_concurrency()` if they are unknown.
+ * @return At least 1.
+ * @throw None
+ */
+inline unsigned core_count(std::vector<int> const& cpus) noexcept
+{
+    return cpus.empty() ? std::max(1u, std::thread::hardware_concurrency()) : unsigned(cpus.size());
+}
+
+/**
+ * Pins the calling thread to `cpu`.
+ * @return whether the affinity could be set.
+ * @throw None
+ */
+inline bool pin_to_cpu(int cpu) noexcept
+{
+#if defined(CPU_SETSIZE)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return ::sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+    (void)cpu;
+    return false;
+#endif
+}
+
+#endif // cpu_affinity_hpp
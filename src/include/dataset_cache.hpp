@@ -0,0 +1,294 @@
+// Shared cache of random benchmark inputs.
+// ======================================================================
+// Copyright (c) 2025 CS GROUP
+//
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// ======================================================================
+//
+// Authors:
+// - Luc Hermitte, initial author
+//
+// ======================================================================
+//
+// Defines:
+// - DatasetCache: a registry of read-only random datasets, generated
+//   once per process and shared by every benchmark that needs the same
+//   inputs.
+// - datasets(): accessor to the process-wide instance.
+
+#ifndef dataset_cache_hpp
+#define dataset_cache_hpp
+
+#include "rng.hpp"
+
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <typeindex>
+#include <vector>
+
+#if __has_include(<unistd.h>)
+#  include <unistd.h>
+#endif
+
+/**
+ * Registry of read-only random datasets.
+ *
+ * Datasets are identified by their type, number of elements, range of
+ * values -- or `RNG` mapping --, seed, and alignment. The first request
+ * generates the data -- with the deterministic mode of `RNG` -- and the
+ * following ones return the same memory. This way, a benchmark suite that sweeps over
+ * operations and sizes doesn't regenerate nor reallocate identical
+ * inputs right before each measurement.
+ *
+ * Memory comes from an arena of page-aligned blocks whose pages are
+ * touched when the block is allocated, so that no page fault is left
+ * for the benchmarks to pay. Everything is released with the cache.
+ *
+ * This class is neither copiable nor moveable. All its functions can
+ * be called concurrently.
+ */
+class DatasetCache
+{
+public:
+    static constexpr std::size_t default_alignment  = 64;
+    static constexpr std::size_t default_block_size = std::size_t(64) << 20;
+
+    /**
+     * Constructor.
+     * @param[in] block_size  Size of the arena blocks. Bigger datasets
+     *                        get a block of their own.
+     * @throw None
+     */
+    explicit DatasetCache(std::size_t block_size = default_block_size)
+    : m_block_size(block_size)
+    {}
+
+    DatasetCache(DatasetCache const&)            = delete;
+    DatasetCache& operator=(DatasetCache const&) = delete;
+
+    /**
+     * Returns a dataset of `count` random numbers in `[min, max]`.
+     * The dataset is generated on the first call, and shared afterward.
+     * @tparam T  Arithmetic type of the elements.
+     * @param[in] count      Number of elements.
+     * @param[in] min        Minimal value.
+     * @param[in] max        Maximal value.
+     * @param[in] seed       Seed of the counter-based generator.
+     * @param[in] alignment  Alignment of the first element, in bytes.
+     * @return A read-only view to the dataset, valid as long as the
+     *         cache lives.
+     * @throw std::invalid_argument if `alignment` isn't a power of 2.
+     * @throw std::bad_alloc if memory is exhausted.
+     * @throw std::system_error if the generation threads can't be
+     *        started.
+     */
+    template <typename T>
+    [[nodiscard]]
+    std::span<T const> get(
+            std::size_t count, T min, T max, std::uint64_t seed,
+            std::size_t alignment = default_alignment)
+    {
+        static_assert(std::is_arithmetic_v<T> && sizeof(T) <= sizeof(std::uint64_t));
+        return get(count, uniform_mapping_t<T>(min, max), seed, alignment);
+    }
+
+    /**
+     * Returns a dataset of `count` random numbers shaped by `mapping`.
+     * The dataset is generated on the first call with the same mapping
+     * parameters, and shared afterward.
+     * @tparam Mapping  Type of the `RNG` mapping, see `zipf_mapping`,
+     *                  `special_values_mapping`...
+     * @param[in] count      Number of elements.
+     * @param[in] mapping    Data shape.
+     * @param[in] seed       Seed of the counter-based generator.
+     * @param[in] alignment  Alignment of the first element, in bytes.
+     * @return A read-only view to the dataset, valid as long as the
+     *         cache lives.
+     * @throw std::invalid_argument if `alignment` isn't a power of 2.
+     * @throw std::bad_alloc if memory is exhausted.
+     * @throw std::system_error if the generation threads can't be
+     *        started.
+     */
+    template <random_mapping Mapping>
+    requires std::three_way_comparable<Mapping>
+    [[nodiscard]]
+    std::span<typename Mapping::value_type const> get(
+            std::size_t count, Mapping const& mapping, std::uint64_t seed,
+            std::size_t alignment = default_alignment)
+    {
+        using T = typename Mapping::value_type;
+        if (alignment == 0 || (alignment & (alignment - 1)) != 0) {
+            throw std::invalid_argument("Dataset alignment shall be a power of 2");
+        }
+        alignment = std::max(alignment, alignof(T));
+
+        typename registry<Mapping>::key const k{mapping, count, seed, alignment};
+
+        std::lock_guard lock(m_mutex);
+        auto& datasets = registry_of<Mapping>().datasets;
+        if (auto const it = datasets.find(k); it != datasets.end()) {
+            return {static_cast<T const*>(it->second), count};
+        }
+        auto* data = static_cast<T*>(allocate(count * sizeof(T), alignment));
+        RNG<T, Mapping>(rng_seed{seed}, mapping, count).fill_parallel({data, count});
+        datasets.emplace(k, data);
+        return {data, count};
+    }
+
+    /** Number of datasets generated so far. */
+    [[nodiscard]]
+    std::size_t size() const
+    {
+        std::lock_guard lock(m_mutex);
+        std::size_t total = 0;
+        for (auto const& [type, r] : m_registries) total += r->size();
+        return total;
+    }
+
+    /** Number of bytes reserved by the arena. */
+    [[nodiscard]]
+    std::size_t reserved_bytes() const
+    {
+        std::lock_guard lock(m_mutex);
+        std::size_t total = 0;
+        for (auto const& b : m_blocks) total += b.size;
+        return total;
+    }
+
+private:
+    struct registry_base
+    {
+        virtual ~registry_base() = default;
+        virtual std::size_t size() const noexcept = 0;
+    };
+
+    /// Datasets generated with one type of mapping.
+    template <typename Mapping>
+    struct registry final : registry_base
+    {
+        struct key
+        {
+            Mapping       mapping;
+            std::size_t   count;
+            std::uint64_t seed;
+            std::size_t   alignment;
+
+            friend bool operator<(key const& lhs, key const& rhs)
+            {
+                return std::tie(lhs.mapping, lhs.count, lhs.seed, lhs.alignment)
+                     < std::tie(rhs.mapping, rhs.count, rhs.seed, rhs.alignment);
+            }
+        };
+
+        std::size_t size() const noexcept override { return datasets.size(); }
+
+        std::map<key, void*> datasets;
+    };
+
+    struct block_deleter
+    {
+        std::size_t alignment;
+        void operator()(std::byte* p) const noexcept
+        {
+            ::operator delete(p, std::align_val_t{alignment});
+        }
+    };
+
+    struct block
+    {
+        std::unique_ptr<std::byte[], block_deleter> data;
+        std::size_t                                 size;
+        std::size_t                                 used;
+    };
+
+    /// @pre `m_mutex` is locked.
+    template <typename Mapping>
+    registry<Mapping>& registry_of()
+    {
+        auto& r = m_registries[typeid(Mapping)];
+        if (!r) r = std::make_unique<registry<Mapping>>();
+        return static_cast<registry<Mapping>&>(*r);
+    }
+
+    static std::size_t page_size() noexcept
+    {
+#if __has_include(<unistd.h>)
+        static std::size_t const size = std::size_t(::sysconf(_SC_PAGESIZE));
+        return size;
+#else
+        return 4096;
+#endif
+    }
+
+    /// Bump allocation in the current block, or in a new one.
+    /// @pre `m_mutex` is locked.
+    void* allocate(std::size_t bytes, std::size_t alignment)
+    {
+        if (!m_blocks.empty()) {
+            auto&             b     = m_blocks.back();
+            std::size_t const first = (b.used + alignment - 1) / alignment * alignment;
+            if (first + bytes <= b.size) {
+                b.used = first + bytes;
+                return b.data.get() + first;
+            }
+        }
+
+        std::size_t const page        = page_size();
+        std::size_t const block_align = std::max(page, alignment);
+        std::size_t const size
+            = (std::max(bytes, m_block_size) + block_align - 1) / block_align * block_align;
+        auto* p = static_cast<std::byte*>(::operator new(size, std::align_val_t{block_align}));
+        block b{{p, block_deleter{block_align}}, size, bytes};
+        // Pre-fault: one write per page is enough
+        for (std::size_t i = 0; i < size; i += page) {
+            p[i] = std::byte{0};
+        }
+        m_blocks.push_back(std::move(b));
+        return p;
+    }
+
+    std::size_t                                                m_block_size;
+    std::map<std::type_index, std::unique_ptr<registry_base>> m_registries;
+    std::vector<block>                                         m_blocks;
+    mutable std::mutex                                         m_mutex;
+};
+
+/**
+ * Process-wide `DatasetCache` shared by every test case.
+ * @throw None
+ */
+inline DatasetCache& datasets()
+{
+    static DatasetCache cache;
+    return cache;
+}
+
+#endif // dataset_cache_hpp
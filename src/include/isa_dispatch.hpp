@@ -0,0 +1,204 @@
+// Kernel variants compiled for several ISAs, dispatched at runtime.
+// ======================================================================
+// Copyright (c) 2025 CS GROUP
+//
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// ======================================================================
+//
+// Authors:
+// - Luc Hermitte, initial author
+//
+// ======================================================================
+//
+// Defines:
+// - Isa: instruction set levels kernels can be compiled for.
+// - isa_name(), isa_supported(): runtime queries about them.
+// - NANOBENCH_ISA_KERNEL(): defines the variants of a kernel, one per
+//   ISA.
+// - run_isa_variants(): benchmarks every variant the CPU supports.
+
+#ifndef isa_dispatch_hpp
+#define isa_dispatch_hpp
+
+#include "nanobench_html_graph_renderer.hpp"
+
+#include <cstddef>
+#include <string>
+
+/**
+ * Instruction set levels.
+ *
+ * On x86-64, they match the psABI micro-architecture levels: `sse2` is
+ * the `x86-64` baseline, `sse4_2` is `x86-64-v2`, `avx2` is `x86-64-v3`,
+ * and `avx512` is `x86-64-v4`. On other architectures, and with other
+ * compilers than GCC and clang, only `generic` is available.
+ */
+enum class Isa { generic, sse2, sse4_2, avx2, avx512 };
+
+/** Label of `isa` for plots: "SSE2", "AVX2"... */
+constexpr char const* isa_name(Isa isa) noexcept
+{
+    switch (isa) {
+        case Isa::generic: return "generic";
+        case Isa::sse2:    return "SSE2";
+        case Isa::sse4_2:  return "SSE4.2";
+        case Isa::avx2:    return "AVX2";
+        case Isa::avx512:  return "AVX-512";
+    }
+    return "?";
+}
+
+/**
+ * Tells whether the CPU -- and the OS -- the program runs on supports
+ * `isa`.
+ * @throw None
+ */
+inline bool isa_supported(Isa isa) noexcept
+{
+#if defined(__x86_64__) && defined(__GNUC__)
+    __builtin_cpu_init();
+    switch (isa) {
+        case Isa::generic:
+        case Isa::sse2:
+            return true;
+        case Isa::sse4_2:
+            return __builtin_cpu_supports("sse4.2") && __builtin_cpu_supports("popcnt");
+        case Isa::avx2:
+            return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")
+                && __builtin_cpu_supports("bmi2");
+        case Isa::avx512:
+            return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")
+                && __builtin_cpu_supports("avx512dq") && __builtin_cpu_supports("avx512vl");
+    }
+    return false;
+#else
+    return isa == Isa::generic;
+#endif
+}
+
+/**
+ * One variant of a kernel: the ISA it's compiled for, and its entry
+ * point.
+ * @tparam Signature  Function type of the kernel.
+ */
+template <typename Signature>
+struct isa_variant
+{
+    Isa        isa;
+    Signature* kernel;
+};
+
+/**
+ * Defines `name`, an array of `isa_variant`, with one variant of the
+ * kernel per `Isa`.
+ *
+ * ```c++
+ * NANOBENCH_ISA_KERNEL(mul_float, (float const* x, float const* y, float* z, std::size_t n), {
+ *     for (std::size_t i = 0; i < n; ++i) z[i] = x[i] * y[i];
+ * })
+ * ```
+ *
+ * Each variant is compiled with `__attribute__((target("arch=...")))`
+ * from the same body, whatever `-march` the rest of the program is
+ * compiled with. The binary stays deployable on any x86-64 host -- as
+ * long as the rest of it is compiled for a baseline, e.g. with
+ * `TARGET_ARCH=-march=x86-64`.
+ *
+ * @warning GCC doesn't inline functions compiled for another `arch`:
+ * the body shall not call anything -- not even `std::span::operator[]`
+ * -- in its inner loop, or the auto-vectorization is lost. Stick to
+ * raw pointers and builtin operators.
+ *
+ * @param name    Name of the array of variants --
+ *                `name##_<isa>` functions are also defined.
+ * @param params  Parenthesized parameter list; the kernels return
+ *                `void`.
+ * @param ...     Body of the kernel, braces included.
+ */
+#if defined(__x86_64__) && defined(__GNUC__)
+// GCC tunes x86-64-v4 for 256-bit vectors by default
+#  if defined(__clang__)
+#    define NANOBENCH_ISA_AVX512_TARGET "arch=x86-64-v4"
+#  else
+#    define NANOBENCH_ISA_AVX512_TARGET "arch=x86-64-v4,prefer-vector-width=512"
+#  endif
+#  define NANOBENCH_ISA_KERNEL(name, params, ...)                                      \
+    __attribute__((target("arch=x86-64"))) inline void name##_sse2 params __VA_ARGS__    \
+    __attribute__((target("arch=x86-64-v2"))) inline void name##_sse4_2 params __VA_ARGS__ \
+    __attribute__((target("arch=x86-64-v3"))) inline void name##_avx2 params __VA_ARGS__ \
+    __attribute__((target(NANOBENCH_ISA_AVX512_TARGET)))                               \
+    inline void name##_avx512 params __VA_ARGS__                                       \
+    inline constexpr isa_variant<void params> name[] = {                              \
+        {Isa::sse2, &name##_sse2},                                                     \
+        {Isa::sse4_2, &name##_sse4_2},                                                 \
+        {Isa::avx2, &name##_avx2},                                                     \
+        {Isa::avx512, &name##_avx512},                                                 \
+    };
+#else
+#  define NANOBENCH_ISA_KERNEL(name, params, ...)                                      \
+    inline void name##_generic params __VA_ARGS__                                      \
+    inline constexpr isa_variant<void params> name[] = {                              \
+        {Isa::generic, &name##_generic},                                               \
+    };
+#endif
+
+/**
+ * Benchmarks, side by side in `bench`, every variant of a kernel the
+ * current CPU supports.
+ *
+ * The results are named "<name> <ISA>". The first variant -- typically
+ * SSE2 -- is the natural baseline of a `relative(true)` bench.
+ *
+ * ```c++
+ * run_isa_variants(b, "*", mul_float, [&](auto kernel) {
+ *     kernel(x.data(), y.data(), z.data(), z.size());
+ *     ankerl::nanobench::doNotOptimizeAway(z);
+ * });
+ * ```
+ *
+ * @tparam Signature  Function type of the kernel.
+ * @tparam Call       Callable taking a `Signature*`, and that calls it
+ *                    with the benchmarked data.
+ * @param[in,out] bench     Benchmark object where results are appended.
+ * @param[in]     name      Prefix of the result names.
+ * @param[in]     variants  Variants defined by `NANOBENCH_ISA_KERNEL()`.
+ * @param[in]     call      Runs one variant once.
+ * @return The number of variants benchmarked.
+ * @throw Whatever `call` or `Bench::run()` may throw.
+ */
+template <typename Signature, std::size_t N, typename Call>
+std::size_t run_isa_variants(
+        ankerl::nanobench::Bench& bench, std::string const& name,
+        isa_variant<Signature> const (&variants)[N], Call&& call)
+{
+    std::size_t nb_run = 0;
+    for (auto const& v : variants) {
+        if (!isa_supported(v.isa)) continue;
+        Signature* const kernel = v.kernel;
+        bench.run(name + " " + isa_name(v.isa), [&]() { call(kernel); });
+        ++nb_run;
+    }
+    return nb_run;
+}
+
+#endif // isa_dispatch_hpp
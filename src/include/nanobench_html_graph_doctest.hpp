@@ -0,0 +1,165 @@
+// Helpers for test cases that render nanobench results with doctest
+// ======================================================================
+// Copyright (c) 2025 CS GROUP
+//
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// ======================================================================
+//
+// Authors:
+// - Luc Hermitte, initial author
+//
+// ======================================================================
+
+// Defines:
+// - Global pointer variables: graph_renderer, json_sidecar,
+//   csv_sidecar, bench_baseline, and topdown_recorder to be used if
+//   not null. They are set by the main() of
+//   nanobench_html_graph_doctest_main.hpp.
+// - render_graph() and render_line_graph(): render a benchmark to every
+//   initialized output.
+// - run_adaptive(): runs a benchmark with the global adaptive_epochs.
+//
+// Unlike nanobench_html_graph_doctest_main.hpp, this header can be
+// included by every translation unit of a suite, see nanobench_impl.cpp.
+
+#ifndef nanobench_html_graph_doctest
+#define nanobench_html_graph_doctest
+
+#include "adaptive_epochs.hpp"
+#include "bench_baseline.hpp"
+#include "nanobench_html_graph_renderer.hpp"
+#include "nanobench_sidecar.hpp"
+#include "topdown_counters.hpp"
+#include <doctest/doctest.h>
+
+#include <string>
+#include <utility>
+
+// I haven't found a better way (than a global) to have this available
+// to every test case
+inline HtmlGraphRenderer * graph_renderer   = nullptr;
+inline BenchSidecar      * json_sidecar     = nullptr;
+inline BenchSidecar      * csv_sidecar      = nullptr;
+inline BenchBaseline     * bench_baseline   = nullptr;
+inline TopdownRecorder   * topdown_recorder = nullptr;
+inline AdaptiveEpochs      adaptive_epochs;
+
+/**
+ * Writes the results of `b` to the JSON and CSV outputs, if
+ * initialized.
+ * @throw std::bad_alloc if memory is exhausted.
+ */
+inline void write_sidecars(ankerl::nanobench::Bench const& b)
+{
+    for (auto* sidecar : {json_sidecar, csv_sidecar}) {
+        if (sidecar) sidecar->write(b);
+    }
+}
+
+/**
+ * Compares the results of `b` to the baseline, if initialized.
+ * The current test case fails for each result that regresses.
+ * @throw std::bad_alloc if memory is exhausted.
+ */
+inline void check_baseline(ankerl::nanobench::Bench const& b)
+{
+    if (!bench_baseline) return;
+    for (auto const& r : b.results()) {
+        auto const* base = bench_baseline->find(b.title(), r);
+        if (!base) continue;
+        auto const c = bench_baseline->compare(r, *base);
+        if (c.regression) {
+            FAIL_CHECK(b.title() << " / " << r.config().mBenchmarkName << " regresses: "
+                       << (c.ratio - 1) * 100 << "% slower than the baseline (p-value: "
+                       << c.p_value << ", threshold: " << bench_baseline->threshold() * 100 << "%)");
+        }
+    }
+}
+
+/**
+ * Runs `op` in `bench` with as many epochs as `adaptive_epochs` needs to
+ * reach its target error, and reports when the time budget didn't
+ * allow it. Its top-down breakdown is also measured, if initialized.
+ * @throw Whatever `Bench::run()` may throw.
+ */
+template <typename Op>
+void run_adaptive(ankerl::nanobench::Bench& bench, std::string const& name, Op&& op)
+{
+    adaptive_outcome outcome{};
+    auto const       run = [&](auto&& kernel) { outcome = adaptive_epochs.run(bench, name, kernel); };
+    if (topdown_recorder) {
+        topdown_recorder->measure(bench, std::forward<Op>(op), run);
+    } else {
+        run(op);
+    }
+    if (!outcome.converged) {
+        MESSAGE(bench.title() << " / " << name << ": error " << outcome.error * 100 << "% after "
+                << outcome.epochs << " epochs, target: " << adaptive_epochs.target_error() * 100 << "%");
+    }
+}
+
+/**
+ * Helper function to render a benchmark into a new graph.
+ * If initialized, the benchmark is rendered into a graph. Nothing is
+ * done otherwise. Its results are also written to the JSON and CSV
+ * outputs, and compared to the baseline, if initialized.
+ * @tparam Strings  Extra parameters forwarded to `HtmlGraphRenderer::render_to()`.
+ * @param[in] b  nanobench micro-benchmark to render as graph.
+ * @param[in] s  Extra parameters to forward to `render_to()`: the
+ *               `<div/>` name, and the plot type.
+ *
+ * @throw std::bad_alloc if memory is exhausted.
+ */
+template <typename... Strings>
+void render_graph(ankerl::nanobench::Bench const& b, Strings const&... s)
+{
+    if (graph_renderer) {
+        graph_renderer->render_to(b, s...);
+    }
+    write_sidecars(b);
+    check_baseline(b);
+}
+
+/**
+ * Helper function to render a line plot of benchmark medians.
+ * If initialized, the plot is rendered. Nothing is done otherwise.
+ * The results are also written to the JSON and CSV outputs, and
+ * compared to the baseline, as with `render_graph()`.
+ * @param[in] b     nanobench micro-benchmark whose results are plotted.
+ * @param[in] plot  Series and markers to draw, see `WorkingSetSweep::plot()`.
+ * @param[in] id    Name for the HTML `<div/>`.
+ *
+ * @throw std::bad_alloc if memory is exhausted.
+ * @throw std::out_of_range if `plot` doesn't match `b` results.
+ */
+inline void render_line_graph(
+        ankerl::nanobench::Bench const& b, LinePlot const& plot, std::string const& id)
+{
+    if (graph_renderer) {
+        graph_renderer->render_lines_to(b, plot, id);
+    }
+    write_sidecars(b);
+    check_baseline(b);
+}
+
+#endif  // nanobench_html_graph_doctest
@@ -33,38 +33,277 @@
 // Defines:
 // - A main() function that replaces what
 //   DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN would have generated to enable a
-//   new parameter: "--renderto=webpage.html".
-// - A global pointer variable: graph_renderer to be used if not null.
+//   new parameters: "--renderto=webpage.html", and "--bench-jobs=N" to
+//   run test cases in parallel processes pinned to different cores.
+//   "--jsonto=results.jsonl" and "--csvto=results.csv" also write the
+//   rendered results in machine-readable formats.
+//   "--baseline=previous.jsonl" compares the rendered results to a
+//   previous run, and fails the test cases where they regress by more
+//   than "--regression-threshold=P" percents.
+//   "--hugepages=thp|2M|1G", "--prefault", and "--numa-node=N" set the
+//   page policy of test_vector.
+//   "--target-error=P" and "--epoch-budget=S" configure run_adaptive().
+//   "--pin-cpu=N" pins the process, and "--check-env=warn|strict|off"
+//   checks the benchmark environment, refusing to run when strict; the
+//   host fingerprint is embedded in the HTML and JSON outputs.
+//   "--topdown" draws the top-down breakdown of the results measured
+//   with run_adaptive().
+//   "--renderpages=DIR" writes the plots to one page per test case, or
+//   per "--plots-per-page=N" plots, listed in DIR/index.html.
+//   The helpers for the test cases are in
+//   nanobench_html_graph_doctest.hpp.
 
 #ifndef nanobench_html_graph_doctest_main
 #define nanobench_html_graph_doctest_main
 
-#include "nanobench_html_graph_renderer.hpp"
+#include "bench_environment.hpp"
+#include "test_vector.hpp"
 #define DOCTEST_CONFIG_IMPLEMENT
-#include <doctest/doctest.h>
+#include "nanobench_html_graph_doctest.hpp"
 
-// I haven't found a better way (than a global) to have this available
-// to every test case
-HtmlGraphRenderer * graph_renderer = nullptr;
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <optional>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
 
+#if __has_include(<sys/wait.h>) && __has_include(<sched.h>)
+#  include "cpu_affinity.hpp"
+#  include <fcntl.h>
+#  include <sys/wait.h>
+#  include <unistd.h>
+#  define NANOBENCH_VIOLIN_HAS_JOBS
+#endif
+
+#if defined(NANOBENCH_VIOLIN_HAS_JOBS)
 /**
- * Helper function to render a benchmark into a new graph.
- * If initialized, the benchmark is rendered into a graph. Nothing is
- * done otherwise.
- * @tparam Strings  Extra parameters forwarded to `HtmlGraphRenderer::skeleton()`.
- * @param[in] b  nanobench micro-benchmark to render as graph.
- * @param[in] s  Extra parameters to forward to `skeleton()`
+ * Support for `--bench-jobs=N`.
  *
- * @throw std::bad_alloc if memory is exhausted.
- * @throw AnyThing that `ankerl::nanobench::render()` may throw.
+ * Test cases are run one per child process, at most N at a time, each
+ * child being pinned to its own core. Their console outputs and plots
+ * are written to temporary files, and merged by the parent process in
+ * the order of the test cases, as if they had been run sequentially.
+ *
+ * Only independent test cases should be run this way: benchmarks that
+ * saturate the last level cache or the memory bandwidth will disturb
+ * each other.
  */
-template <typename... Strings>
-void render_graph(ankerl::nanobench::Bench const& b, Strings const&... s)
+namespace bench_jobs
 {
-    if (graph_renderer) {
-        graph_renderer->render_to(b, s...);
+/**
+ * doctest listener that records how many test cases pass the filters,
+ * when doctest is run with `--count`.
+ */
+struct TestCaseCounter : doctest::IReporter
+{
+    static inline unsigned count = 0;
+
+    explicit TestCaseCounter(doctest::ContextOptions const&) {}
+
+    void report_query(doctest::QueryData const& in) override
+    {
+        if (in.run_stats) count = in.run_stats->numTestCasesPassingFilters;
+    }
+    void test_run_start() override {}
+    void test_run_end(doctest::TestRunStats const&) override {}
+    void test_case_start(doctest::TestCaseData const&) override {}
+    void test_case_reenter(doctest::TestCaseData const&) override {}
+    void test_case_end(doctest::CurrentTestCaseStats const&) override {}
+    void test_case_exception(doctest::TestCaseException const&) override {}
+    void subcase_start(doctest::SubcaseSignature const&) override {}
+    void subcase_end() override {}
+    void log_assert(doctest::AssertData const&) override {}
+    void log_message(doctest::MessageData const&) override {}
+    void test_case_skipped(doctest::TestCaseData const&) override {}
+};
+
+/** Number of test cases that pass the command line filters. */
+inline unsigned count_test_cases(int argc, char** argv)
+{
+    doctest::Context ctx;
+    ctx.applyCommandLine(argc, argv);
+    ctx.setOption("count", true);
+    ctx.setOption("out", "/dev/null");
+    ctx.run();
+    return TestCaseCounter::count;
+}
+
+/**
+ * Runs the test case number `index` -- from 1 -- in a child process,
+ * pinned to `cpu` unless it's negative.
+ * @return doctest exit code.
+ */
+inline int run_child(int argc, char** argv, unsigned index, int cpu, std::string const& prefix)
+{
+    if (cpu >= 0) pin_to_cpu(cpu);
+
+    std::string const log = prefix + std::to_string(index) + ".log";
+    int const         fd  = ::open(log.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return EXIT_FAILURE;
+    ::dup2(fd, STDOUT_FILENO);
+    ::dup2(fd, STDERR_FILENO);
+    ::close(fd);
+
+    if (graph_renderer && graph_renderer->paged()) {
+        graph_renderer->detach();
+        graph_renderer->pages_fragment(prefix + std::to_string(index) + ".index",
+                "page-" + std::to_string(index) + "-");
+    } else if (graph_renderer) {
+        graph_renderer->detach();
+        graph_renderer->open_fragment(prefix + std::to_string(index) + ".html");
+    }
+    if (json_sidecar) {
+        json_sidecar->detach();
+        json_sidecar->open_fragment(prefix + std::to_string(index) + ".jsonl");
+    }
+    if (csv_sidecar) {
+        csv_sidecar->detach();
+        csv_sidecar->open_fragment(prefix + std::to_string(index) + ".csv");
+    }
+
+    doctest::Context ctx;
+    ctx.applyCommandLine(argc, argv);
+    ctx.setOption("first", int(index));
+    ctx.setOption("last", int(index));
+    int const res = ctx.run();
+
+    if (graph_renderer && graph_renderer->paged()) {
+        graph_renderer->close();
+    } else if (graph_renderer) {
+        graph_renderer->flush();
+        graph_renderer->detach();
+    }
+    for (auto* sidecar : {json_sidecar, csv_sidecar}) {
+        if (sidecar) sidecar->detach();
+    }
+    std::cout.flush();
+    std::cerr.flush();
+    return res;
+}
+
+/**
+ * Runs every test case in a child process, `jobs` at a time.
+ * @throw std::system_error if child processes cannot be created.
+ * @throw std::runtime_error if child outputs cannot be merged.
+ */
+inline int run(int argc, char** argv, unsigned jobs)
+{
+    unsigned const         count = count_test_cases(argc, argv);
+    std::vector<int> const cpus  = allowed_cpus();
+    std::string const      prefix
+        = (std::filesystem::temp_directory_path()
+           / ("nanobench-violin-" + std::to_string(::getpid()) + "-"))
+              .string();
+
+    // Nothing shall remain in the buffers children inherit
+    if (graph_renderer) graph_renderer->flush();
+    for (auto* sidecar : {json_sidecar, csv_sidecar}) {
+        if (sidecar) sidecar->flush();
+    }
+    std::cout.flush();
+    std::fflush(nullptr);
+
+    int                       res = EXIT_SUCCESS;
+    std::map<pid_t, unsigned> running; // pid -> slot
+    std::vector<unsigned>     free_slots;
+    for (unsigned slot = jobs; slot > 0; --slot) free_slots.push_back(slot - 1);
+
+    auto wait_one = [&] {
+        int         status = 0;
+        pid_t const pid    = ::wait(&status);
+        if (pid < 0) throw std::system_error(errno, std::generic_category(), "wait");
+        free_slots.push_back(running.at(pid));
+        running.erase(pid);
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) res = EXIT_FAILURE;
+    };
+
+    for (unsigned index = 1; index <= count; ++index) {
+        if (free_slots.empty()) wait_one();
+        unsigned const slot = free_slots.back();
+        pid_t const    pid  = ::fork();
+        if (pid < 0) throw std::system_error(errno, std::generic_category(), "fork");
+        if (pid == 0) {
+            int child_res = EXIT_FAILURE;
+            try {
+                // Left unpinned when the allowed CPUs are unknown
+                int const cpu = cpus.empty() ? -1 : cpus[slot % cpus.size()];
+                child_res     = run_child(argc, argv, index, cpu, prefix);
+            } catch (std::exception const& e) {
+                std::cerr << "Test case #" << index << " failed: " << e.what() << "\n";
+            }
+            std::_Exit(child_res);
+        }
+        free_slots.pop_back();
+        running.emplace(pid, slot);
+    }
+    while (!running.empty()) wait_one();
+
+    // Merge in the order of the test cases
+    for (unsigned index = 1; index <= count; ++index) {
+        std::string const log   = prefix + std::to_string(index) + ".log";
+        std::string const plots = prefix + std::to_string(index) + ".html";
+        std::string const pages = prefix + std::to_string(index) + ".index";
+        std::string const json  = prefix + std::to_string(index) + ".jsonl";
+        std::string const csv   = prefix + std::to_string(index) + ".csv";
+        if (std::ifstream in(log); in && in.peek() != std::ifstream::traits_type::eof()) {
+            std::cout << in.rdbuf();
+        }
+        if (graph_renderer && std::filesystem::exists(plots)) {
+            graph_renderer->append_fragment(plots);
+        }
+        if (graph_renderer && std::filesystem::exists(pages)) {
+            graph_renderer->append_pages_fragment(pages);
+        }
+        if (json_sidecar && std::filesystem::exists(json)) json_sidecar->append_fragment(json);
+        if (csv_sidecar && std::filesystem::exists(csv)) csv_sidecar->append_fragment(csv);
+        std::filesystem::remove(log);
+        std::filesystem::remove(plots);
+        std::filesystem::remove(pages);
+        std::filesystem::remove(json);
+        std::filesystem::remove(csv);
     }
+    std::cout << "[nanobench] " << count << " test cases run with " << jobs << " jobs"
+              << (res == EXIT_SUCCESS ? "\n" : ", some failed\n");
+    return res;
 }
+} // bench_jobs namespace
+
+// The listener is executed in every run, but only reacts to `--count`
+DOCTEST_REGISTER_LISTENER("nanobench_violin_counter", 0, bench_jobs::TestCaseCounter);
+#endif
+
+/**
+ * doctest listener that starts a new page of the `--renderpages` output
+ * for each test case.
+ */
+struct PagePerTestCase : doctest::IReporter
+{
+    explicit PagePerTestCase(doctest::ContextOptions const&) {}
+
+    void report_query(doctest::QueryData const&) override {}
+    void test_run_start() override {}
+    void test_run_end(doctest::TestRunStats const&) override {}
+    void test_case_start(doctest::TestCaseData const& in) override
+    {
+        if (graph_renderer) graph_renderer->page(in.m_name);
+    }
+    void test_case_reenter(doctest::TestCaseData const&) override {}
+    void test_case_end(doctest::CurrentTestCaseStats const&) override {}
+    void test_case_exception(doctest::TestCaseException const&) override {}
+    void subcase_start(doctest::SubcaseSignature const&) override {}
+    void subcase_end() override {}
+    void log_assert(doctest::AssertData const&) override {}
+    void log_message(doctest::MessageData const&) override {}
+    void test_case_skipped(doctest::TestCaseData const&) override {}
+};
+DOCTEST_REGISTER_LISTENER("nanobench_violin_pages", 0, PagePerTestCase);
 
 #ifndef NANOBENCH_VIOLIN_OPTIONS
 /**
@@ -89,21 +328,156 @@ DOCTEST_MSVC_SUPPRESS_WARNING_WITH_PUSH(4007) // 'function' : must be 'attribute
 int main(int argc, char** argv)
 {
     auto ctx = doctest::Context();
+    // Declared first: the renderer may use them until it's destroyed
+    std::optional<BenchBaseline>   l_baseline;
+    std::optional<TopdownRecorder> l_topdown;
+    // Plots are rendered once all the test cases have been run, not
+    // between them
     auto l_output = HtmlGraphRenderer("violin")
         .showlegend(true)
+        .deferred(true)
+        .showcontext({"pages"})
         NANOBENCH_VIOLIN_OPTIONS
         ;
 
     ctx.applyCommandLine(argc, argv);
     doctest::String output_filename;
     doctest::parseOption(argc, argv, DOCTEST_CONFIG_OPTIONS_PREFIX "renderto=", &output_filename, "");
+    doctest::String pages_directory;
+    doctest::parseOption(argc, argv, DOCTEST_CONFIG_OPTIONS_PREFIX "renderpages=", &pages_directory, "");
+    doctest::String per_page_option;
+    doctest::parseOption(argc, argv, DOCTEST_CONFIG_OPTIONS_PREFIX "plots-per-page=", &per_page_option, "0");
+    doctest::String json_filename;
+    doctest::parseOption(argc, argv, DOCTEST_CONFIG_OPTIONS_PREFIX "jsonto=", &json_filename, "");
+    doctest::String csv_filename;
+    doctest::parseOption(argc, argv, DOCTEST_CONFIG_OPTIONS_PREFIX "csvto=", &csv_filename, "");
+    doctest::String baseline_filename;
+    doctest::parseOption(argc, argv, DOCTEST_CONFIG_OPTIONS_PREFIX "baseline=", &baseline_filename, "");
+    doctest::String threshold_option;
+    doctest::parseOption(argc, argv, DOCTEST_CONFIG_OPTIONS_PREFIX "regression-threshold=", &threshold_option, "5");
+    doctest::String jobs_option;
+    doctest::parseOption(argc, argv, DOCTEST_CONFIG_OPTIONS_PREFIX "bench-jobs=", &jobs_option, "1");
+    unsigned const jobs = unsigned(std::strtoul(jobs_option.c_str(), nullptr, 10));
 
-    if (output_filename.size() > 0) {
+    // Set before any test case allocates: the children of --bench-jobs
+    // inherit it
+    page_policy pages;
+    doctest::String pages_option;
+    doctest::parseOption(argc, argv, DOCTEST_CONFIG_OPTIONS_PREFIX "hugepages=", &pages_option, "none");
+    std::string const page_size = pages_option.c_str();
+    if (page_size == "thp") {
+        pages.page_size = PageSize::transparent;
+    } else if (page_size == "2M") {
+        pages.page_size = PageSize::huge_2M;
+    } else if (page_size == "1G") {
+        pages.page_size = PageSize::huge_1G;
+    } else if (page_size != "none") {
+        std::cerr << "[nanobench] Unknown --hugepages=" << page_size << ", expecting thp, 2M, or 1G\n";
+    }
+    pages.prefault = doctest::parseFlag(argc, argv, DOCTEST_CONFIG_OPTIONS_PREFIX "prefault");
+    doctest::String node_option;
+    doctest::parseOption(argc, argv, DOCTEST_CONFIG_OPTIONS_PREFIX "numa-node=", &node_option, "-1");
+    pages.numa_node = int(std::strtol(node_option.c_str(), nullptr, 10));
+    page_arena().policy(pages);
+
+    doctest::String error_option;
+    doctest::parseOption(argc, argv, DOCTEST_CONFIG_OPTIONS_PREFIX "target-error=", &error_option, "1");
+    doctest::String budget_option;
+    doctest::parseOption(argc, argv, DOCTEST_CONFIG_OPTIONS_PREFIX "epoch-budget=", &budget_option, "10");
+    adaptive_epochs = AdaptiveEpochs(
+            std::strtod(error_option.c_str(), nullptr) / 100,
+            AdaptiveEpochs::duration(std::strtod(budget_option.c_str(), nullptr)));
+
+    // Pinned and checked before anything is measured
+    doctest::String pin_option;
+    doctest::parseOption(argc, argv, DOCTEST_CONFIG_OPTIONS_PREFIX "pin-cpu=", &pin_option, "-1");
+    int pinned_cpu = int(std::strtol(pin_option.c_str(), nullptr, 10));
+    if (pinned_cpu >= 0 && jobs > 1) {
+        std::cerr << "[nanobench] --pin-cpu is ignored with --bench-jobs: each job is pinned to its own core\n";
+        pinned_cpu = -1;
+    } else if (pinned_cpu >= 0 && !pin_to_cpu(pinned_cpu)) {
+        std::cerr << "[nanobench] Cannot pin the process to cpu " << pinned_cpu << "\n";
+        pinned_cpu = -1;
+    }
+    doctest::String env_option;
+    doctest::parseOption(argc, argv, DOCTEST_CONFIG_OPTIONS_PREFIX "check-env=", &env_option, "warn");
+    std::string const               env_mode = env_option.c_str();
+    std::optional<BenchEnvironment> environment;
+    if (env_mode != "off") {
+        if (env_mode != "warn" && env_mode != "strict") {
+            std::cerr << "[nanobench] Unknown --check-env=" << env_mode << ", expecting warn, strict, or off\n";
+        }
+        environment = BenchEnvironment::detect(pinned_cpu);
+        for (auto const& c : environment->checks()) {
+            if (!c.ok) std::cerr << "[nanobench] Unreliable environment: " << c.name << " " << c.value << " -- " << c.advice << "\n";
+        }
+        if (env_mode == "strict" && !environment->ok()) {
+            std::cerr << "[nanobench] Refusing to run benchmarks, see --check-env\n";
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (output_filename.size() > 0 && pages_directory.size() > 0) {
+        std::cerr << "[nanobench] --renderto is ignored with --renderpages\n";
+    }
+    if (pages_directory.size() > 0) {
+        graph_renderer = &l_output;
+        graph_renderer->open_pages(pages_directory.c_str(), std::strtoul(per_page_option.c_str(), nullptr, 10));
+    } else if (output_filename.size() > 0) {
         graph_renderer = &l_output;
         graph_renderer->open(output_filename.c_str());
     }
+    if (graph_renderer && environment) graph_renderer->preamble(environment->html());
+    if (baseline_filename.size() > 0) {
+        try {
+            l_baseline.emplace(std::strtod(threshold_option.c_str(), nullptr) / 100);
+            l_baseline->load(baseline_filename.c_str());
+        } catch (std::exception const& e) {
+            std::cerr << "[nanobench] " << e.what() << "\n";
+            return EXIT_FAILURE;
+        }
+        bench_baseline = &*l_baseline;
+        l_output.baseline([](std::string const& title, ankerl::nanobench::Result const& r) {
+            return bench_baseline->find(title, r);
+        });
+    }
+    if (doctest::parseFlag(argc, argv, DOCTEST_CONFIG_OPTIONS_PREFIX "topdown")) {
+        TopdownCounters const probe;
+        if (probe.level() == 0 && !probe.has_cache_misses()) {
+            std::cerr << "[nanobench] --topdown: no perf_event counter available, see perf_event_paranoid\n";
+        } else if (probe.level() == 0) {
+            std::cerr << "[nanobench] --topdown: no top-down event on this CPU, only cache misses are measured\n";
+        }
+        topdown_recorder = &l_topdown.emplace();
+        l_output.topdown([](std::string const& title, ankerl::nanobench::Result const& r) {
+            return topdown_recorder->find(title, r);
+        });
+    }
+    // Context variables set by the toolbox helpers
+    auto l_json = BenchSidecar(SidecarFormat::json_lines).contexts({"pages", "cache"});
+    auto l_csv  = BenchSidecar(SidecarFormat::csv).contexts({"pages", "cache"});
+    if (environment) l_json.metadata(environment->all_fields());
+    if (json_filename.size() > 0) {
+        json_sidecar = &l_json;
+        json_sidecar->open(json_filename.c_str());
+    }
+    if (csv_filename.size() > 0) {
+        csv_sidecar = &l_csv;
+        csv_sidecar->open(csv_filename.c_str());
+    }
 
-    return ctx.run();
+#if defined(NANOBENCH_VIOLIN_HAS_JOBS)
+    int const res = jobs > 1 ? bench_jobs::run(argc, argv, jobs) : ctx.run();
+#else
+    if (jobs > 1) {
+        std::cerr << "[nanobench] --bench-jobs isn't supported on this platform\n";
+    }
+    int const res = ctx.run();
+#endif
+    if (graph_renderer) {
+        graph_renderer->flush();
+    }
+    return res;
 }
 DOCTEST_MSVC_SUPPRESS_WARNING_POP
 
@@ -31,23 +31,164 @@
 // ======================================================================
 //
 // Defines:
-// - HtmlGraphRenderer meant to be used in nanobench::Bench::render()
+// - HtmlGraphRenderer meant to render nanobench::Bench results.
 //   It will trace several benchmarks instead of only 1 as it's done by
 //   ankerl::nanobench::templates::htmlBoxplot()
 //   Also an option permits to choose violin graphs instead of box
 //   graphs
+// - LinePlot: description of a line plot of medians, like the
+//   throughput-vs-working-set curves produced by WorkingSetSweep.
+// - ViolinPlot: description of grouped violins of raw samples, like the
+//   results of several runs merged by merge_sidecars.
+// - topdown_breakdown: pipeline slots and cache misses of a result,
+//   drawn as stacked bars under its violin.
+// See also changepoints.hpp, for the epoch-ordered time series, and
+// violin_summary.hpp, for the violins precomputed by summarize().
 
 #ifndef nanobench_html_graph_renderer
 #define nanobench_html_graph_renderer
 
-#define ANKERL_NANOBENCH_IMPLEMENT
+// Suites split over several translation units define
+// NANOBENCH_VIOLIN_SEPARATE_IMPLEMENTATION, and link nanobench_impl.cpp
+#if !defined(NANOBENCH_VIOLIN_SEPARATE_IMPLEMENTATION)
+#  define ANKERL_NANOBENCH_IMPLEMENT
+#endif
 // #define ANKERL_NANOBENCH_LOG_ENABLED
 #include <nanobench.h>
 
+#include "changepoints.hpp"
+#include "violin_summary.hpp"
+
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
 #include <fstream>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#if defined(NANOBENCH_HTML_GRAPH_USE_ZLIB)
+// Requires linking with -lz
+#  include <zlib.h>
+#endif
+
+/**
+ * How measurements are embedded in the generated HTML.
+ * - `text`: decimal JavaScript array literals -- the default.
+ * - `float32`, `float64`: base64 encoded `Float32Array`/`Float64Array`,
+ *   decoded by the browser. Files are 3 to 5 times smaller, and faster
+ *   to load. Single precision is more than enough for timings.
+ */
+enum class PayloadEncoding
+{
+    text,
+    float32,
+    float64,
+};
+
+/**
+ * Values plotted for each benchmark.
+ * All but `elapsed` require `Bench::performanceCounters(true)` and a
+ * system where nanobench can read them. Results for which a counter is
+ * missing have empty plots.
+ */
+enum class Metric
+{
+    elapsed,               ///< Time per unit
+    cycles_per_unit,       ///< CPU cycles per unit
+    instructions_per_unit, ///< Instructions per unit
+    ipc,                   ///< Instructions per cycle
+    branch_miss_rate,      ///< Branch misses per branch instruction
+    throughput,            ///< Units per second, e.g. GB/s with `Bench::unit("B")`
+};
+
+/**
+ * Description of a line plot where each point is the median of a
+ * nanobench result.
+ *
+ * The results are designated by their index in
+ * `ankerl::nanobench::Bench::results()`. Series may also carry explicit
+ * values, e.g. for references like an ideal scaling.
+ */
+struct LinePlot
+{
+    struct Series
+    {
+        std::string              name;
+        std::vector<double>      x;
+        std::vector<std::size_t> results; ///< Same size as `x`, or empty
+        std::vector<double>      y;       ///< Explicit values, used when `results` is empty;
+                                          ///< in units per second in `throughput` mode
+        std::string              dash;    ///< Plotly line dash: "dash", "dot"...
+    };
+
+    /// Line drawn across the plot, e.g. a cache boundary.
+    struct Marker
+    {
+        double      x; ///< Or y for `y_markers`
+        std::string label;
+    };
+
+    std::string         x_title;
+    std::string         y_title;            ///< Default title if empty
+    double              y_scale    = 1.0;   ///< Factor on medians per unit, e.g. 1e9 to plot nanoseconds
+    bool                log_x      = true;
+    bool                throughput = false; ///< Units per second instead of time per unit
+    std::vector<Series> series;
+    std::vector<Marker> markers;
+    std::vector<Marker> y_markers;          ///< Horizontal lines, e.g. latency plateaus
+};
+
+/**
+ * Description of grouped violins of raw samples, that don't come from a
+ * `Bench`.
+ */
+struct ViolinPlot
+{
+    struct Trace
+    {
+        std::string         name;  ///< Traces with the same name are side by side
+        std::string         group; ///< E.g. the host or build the samples come from
+        std::vector<double> y;
+    };
+
+    std::string        title;
+    std::string        y_title = "time per unit";
+    std::vector<Trace> traces;
+};
+
+/**
+ * How the pipeline slots of a result have been used, from the top-down
+ * analysis, and its cache misses. See `HtmlGraphRenderer::topdown()`.
+ */
+struct topdown_breakdown
+{
+    struct Component
+    {
+        std::string name;     ///< E.g. "retiring", "backend memory bound"
+        double      fraction; ///< Of the pipeline slots
+        std::string color;    ///< CSS color, plotly's palette when empty
+    };
+
+    std::vector<Component> slots;      ///< Summing to 1, from the bottom of the bar
+    double                 l1d_misses = std::numeric_limits<double>::quiet_NaN(); ///< Per unit: per call / batch()
+    double                 llc_misses = std::numeric_limits<double>::quiet_NaN(); ///< Per unit: per call / batch()
+};
 
 /** Helper class that builds an HTML graph rendered for the
  * microbenchmarks.
@@ -81,6 +222,12 @@
 class HtmlGraphRenderer
 {
 public:
+    /** Elapsed times per unit of the baseline of a result, see `baseline()`. */
+    using baseline_lookup = std::function<std::vector<double> const*(
+            std::string const& title, ankerl::nanobench::Result const& r)>;
+    /** Top-down breakdown of a result, see `topdown()`. */
+    using topdown_lookup = std::function<topdown_breakdown const*(
+            std::string const& title, ankerl::nanobench::Result const& r)>;
 
     /**
      * Only constructor.
@@ -132,7 +279,50 @@ public:
     template <typename Self>
     Self&& showepochs(this Self&& self, bool do_show)
     {
-        self.m_show_epochs  = do_show ? "; epochs: {{epochs}}" : "";
+        self.m_show_epochs  = do_show;
+        return std::forward<Self>(self);
+    }
+
+    /**
+     * Tells to draw, after each plot of a `Bench`, the elapsed times of
+     * its results in the order of their epochs, with their rolling
+     * median. The epochs where the distribution shifts -- see
+     * `changepoints()` -- are marked: a shift in the first epochs means
+     * the warmup wasn't long enough, later ones are typically caused by
+     * frequency scaling or throttling.
+     *
+     * Setter meant to be used from _builder pattern_.
+     * It works on lvalue and rvalue instances of `HtmlGraphRenderer`.
+     * @param[in] do_show  Shall we draw the time series?
+     * @return this
+     */
+    template <typename Self>
+    Self&& timeseries(this Self&& self, bool do_show)
+    {
+        self.m_timeseries = do_show;
+        return std::forward<Self>(self);
+    }
+
+    /**
+     * Tells to compute the violins in C++ -- quartiles, whiskers, mean,
+     * and a density estimate of `resolution` points, see
+     * `summarize_violin()` -- and to only embed these summaries in the
+     * report. Its size and the time the browser takes to draw it then
+     * no longer depend on the number of epochs.
+     *
+     * Setter meant to be used from _builder pattern_.
+     * It works on lvalue and rvalue instances of `HtmlGraphRenderer`.
+     * @param[in] resolution  Number of points of each density; 0 lets
+     *                        plotly compute the violins from the raw
+     *                        samples, as by default.
+     * @param[in] raw_points  Shall the raw samples be drawn too?
+     * @return this
+     */
+    template <typename Self>
+    Self&& summarize(this Self&& self, std::size_t resolution, bool raw_points = false)
+    {
+        self.m_kde_points = resolution;
+        self.m_raw_points = raw_points;
         return std::forward<Self>(self);
     }
 
@@ -154,6 +344,229 @@ public:
         return std::forward<Self>(self);
     }
 
+    /**
+     * Sets how measurements are embedded in the HTML file.
+     *
+     * Setter meant to be used from _builder pattern_.
+     * It works on lvalue and rvalue instances of `HtmlGraphRenderer`.
+     * @param[in] encoding  `PayloadEncoding::text` by default.
+     * @return this
+     */
+    template <typename Self>
+    Self&& encoding(this Self&& self, PayloadEncoding encoding)
+    {
+        self.m_encoding = encoding;
+        return std::forward<Self>(self);
+    }
+
+    /**
+     * Sets the metrics to plot.
+     * With more than one metric, each benchmark gets one subplot per
+     * metric, stacked and sharing the same x-axis. Clicking on a legend
+     * item toggles the result in all the subplots.
+     *
+     * Setter meant to be used from _builder pattern_.
+     * It works on lvalue and rvalue instances of `HtmlGraphRenderer`.
+     * @param[in] metrics  `{Metric::elapsed}` by default.
+     * @return this
+     * @pre `metrics` isn't empty.
+     */
+    template <typename Self>
+    Self&& metrics(this Self&& self, std::vector<Metric> metrics)
+    {
+        assert(!metrics.empty());
+        self.m_metrics = std::move(metrics);
+        return std::forward<Self>(self);
+    }
+
+    /**
+     * Sets the bandwidth drawn as a horizontal line on throughput plots
+     * of benchmarks whose unit is the byte.
+     *
+     * Setter meant to be used from _builder pattern_.
+     * It works on lvalue and rvalue instances of `HtmlGraphRenderer`.
+     * @param[in] bytes_per_second  Peak bandwidth; not drawn if 0.
+     * @param[in] label             Label of the line.
+     * @return this
+     */
+    template <typename Self>
+    Self&& peakbandwidth(this Self&& self, double bytes_per_second, std::string label = "peak")
+    {
+        self.m_peak_bandwidth = bytes_per_second;
+        self.m_peak_label     = std::move(label);
+        return std::forward<Self>(self);
+    }
+
+    /**
+     * Tells which `Bench::context()` variables to display under plot
+     * titles -- e.g. the page size `test_vector` allocations got.
+     *
+     * Setter meant to be used from _builder pattern_.
+     * It works on lvalue and rvalue instances of `HtmlGraphRenderer`.
+     * @param[in] names  Context variables; the ones a benchmark doesn't
+     *                   define are ignored.
+     * @return this
+     */
+    template <typename Self>
+    Self&& showcontext(this Self&& self, std::vector<std::string> names)
+    {
+        self.m_context = std::move(names);
+        return std::forward<Self>(self);
+    }
+
+    /**
+     * Pairs violins -- or boxes -- by a `Bench::context()` variable.
+     * Results with the same name are drawn side by side, one per value
+     * of the variable, e.g. "warm" and "cold"; each value has its own
+     * color.
+     *
+     * Setter meant to be used from _builder pattern_.
+     * It works on lvalue and rvalue instances of `HtmlGraphRenderer`.
+     * @param[in] name  Context variable; benchmarks whose results don't
+     *                  define it are drawn as usual.
+     * @return this
+     */
+    template <typename Self>
+    Self&& groupby(this Self&& self, std::string name)
+    {
+        self.m_group_by = std::move(name);
+        return std::forward<Self>(self);
+    }
+
+    /**
+     * Draws the results of a previous run next to the current ones.
+     * Baseline and current violins of each result are paired, as with
+     * `groupby()`. Baselines only have elapsed times: they're drawn on
+     * the elapsed time and throughput subplots.
+     *
+     * Setter meant to be used from _builder pattern_.
+     * It works on lvalue and rvalue instances of `HtmlGraphRenderer`.
+     * @param[in] lookup  Returns the elapsed times per unit of the
+     *                    baseline of a result -- or nullptr --, from the
+     *                    benchmark title and the result, e.g.
+     *                    `BenchBaseline::find()`. It's called when the
+     *                    plots are written.
+     * @return this
+     */
+    template <typename Self>
+    Self&& baseline(this Self&& self, baseline_lookup lookup)
+    {
+        self.m_baseline = std::move(lookup);
+        return std::forward<Self>(self);
+    }
+
+    /**
+     * Draws the top-down breakdown of the results as stacked bars, in a
+     * subplot under the violins. The L1D and LLC misses per unit are
+     * appended to the names of the results.
+     *
+     * Setter meant to be used from _builder pattern_.
+     * It works on lvalue and rvalue instances of `HtmlGraphRenderer`.
+     * @param[in] lookup  Returns the breakdown of a result -- or
+     *                    nullptr --, from the benchmark title and the
+     *                    result, e.g. `TopdownRecorder::find()`. It's
+     *                    called when the plots are written.
+     * @return this
+     */
+    template <typename Self>
+    Self&& topdown(this Self&& self, topdown_lookup lookup)
+    {
+        self.m_topdown = std::move(lookup);
+        return std::forward<Self>(self);
+    }
+
+    /**
+     * Tells to defer all serialization and file writes to `flush()`.
+     * `render_to()` and `render_lines_to()` then only capture a copy of
+     * the benchmark results: no serialization nor I/O happens
+     * between two benchmarks, that would otherwise start with disturbed
+     * caches.
+     *
+     * Setter meant to be used from _builder pattern_.
+     * It works on lvalue and rvalue instances of `HtmlGraphRenderer`.
+     * @param[in] do_defer  Shall we defer rendering?
+     * @return this
+     */
+    template <typename Self>
+    Self&& deferred(this Self&& self, bool do_defer)
+    {
+        self.m_deferred = do_defer;
+        return std::forward<Self>(self);
+    }
+
+    /**
+     * Tells to draw each plot only when it scrolls into view.
+     * With hundreds of benchmarks in the same file, drawing everything
+     * when the page opens freezes the browser for seconds.
+     *
+     * Setter meant to be used from _builder pattern_.
+     * It works on lvalue and rvalue instances of `HtmlGraphRenderer`.
+     * @param[in] do_lazy  Shall we defer plot drawing?
+     * @return this
+     * @see https://developer.mozilla.org/en-US/docs/Web/API/Intersection_Observer_API
+     */
+    template <typename Self>
+    Self&& lazyplots(this Self&& self, bool do_lazy)
+    {
+        self.m_lazy = do_lazy;
+        return std::forward<Self>(self);
+    }
+
+    /**
+     * Tells to purge lazy plots that leave the view, so that browser
+     * memory doesn't grow with the number of plots seen.
+     * Ignored if `lazyplots()` isn't set.
+     *
+     * Setter meant to be used from _builder pattern_.
+     * It works on lvalue and rvalue instances of `HtmlGraphRenderer`.
+     * @param[in] do_purge  Shall we purge plots out of view?
+     * @return this
+     */
+    template <typename Self>
+    Self&& purgeoffscreen(this Self&& self, bool do_purge)
+    {
+        self.m_purge_offscreen = do_purge;
+        return std::forward<Self>(self);
+    }
+
+    /**
+     * Tells where the pages load plotly from -- the CDN by default.
+     * All the pages of `open_pages()` share it, so the browser loads it
+     * once; a local copy, e.g. next to the pages, permits to browse them
+     * offline.
+     *
+     * Setter meant to be used from _builder pattern_.
+     * It works on lvalue and rvalue instances of `HtmlGraphRenderer`.
+     * @param[in] url  URL of the plotly script, relative to the pages.
+     * @return this
+     */
+    template <typename Self>
+    Self&& plotlyurl(this Self&& self, std::string url)
+    {
+        self.m_plotly_url = std::move(url);
+        return std::forward<Self>(self);
+    }
+
+#  if defined(NANOBENCH_HTML_GRAPH_USE_ZLIB)
+    /**
+     * Tells to deflate binary payloads.
+     * They are inflated by the browser with `DecompressionStream`.
+     * Ignored with `PayloadEncoding::text`.
+     *
+     * Setter meant to be used from _builder pattern_.
+     * It works on lvalue and rvalue instances of `HtmlGraphRenderer`.
+     * @param[in] do_compress  Shall we compress the measurements?
+     * @return this
+     * @see https://developer.mozilla.org/en-US/docs/Web/API/DecompressionStream
+     */
+    template <typename Self>
+    Self&& compress(this Self&& self, bool do_compress)
+    {
+        self.m_compress = do_compress;
+        return std::forward<Self>(self);
+    }
+#  endif
+
 #else
     // Same setters, but overloaded for lvalues and rvalues, before C++23 "explicit this parameter"
     // feature.
@@ -170,12 +583,36 @@ public:
 
     HtmlGraphRenderer&& showepochs(bool do_show) &&
     {
-        m_show_epochs  = do_show ? "; epochs: {{epochs}}" : "";
+        m_show_epochs  = do_show;
         return std::move(*this);
     }
     HtmlGraphRenderer& showepochs(bool do_show) &
     {
-        m_show_epochs  = do_show ? "; epochs: {{epochs}}" : "";
+        m_show_epochs  = do_show;
+        return *this;
+    }
+
+    HtmlGraphRenderer&& timeseries(bool do_show) &&
+    {
+        m_timeseries = do_show;
+        return std::move(*this);
+    }
+    HtmlGraphRenderer& timeseries(bool do_show) &
+    {
+        m_timeseries = do_show;
+        return *this;
+    }
+
+    HtmlGraphRenderer&& summarize(std::size_t resolution, bool raw_points = false) &&
+    {
+        m_kde_points = resolution;
+        m_raw_points = raw_points;
+        return std::move(*this);
+    }
+    HtmlGraphRenderer& summarize(std::size_t resolution, bool raw_points = false) &
+    {
+        m_kde_points = resolution;
+        m_raw_points = raw_points;
         return *this;
     }
 
@@ -189,144 +626,1708 @@ public:
         m_range_mode = !empty(mode) ? ", rangemode: '" + mode + "'" : "";
         return *this;
     }
-#endif
 
-    /**
-     * Opens the output HTML file and starts filling it.
-     * Tries to open `filename`. An exception is thrown if not possible.
-     * Otherwise, HTML header and `<body>` are automatically filled.
-     * @param[in] filename  Output HTML filename.
-     * @throw std::runtime_error is `filename` cannot be opened.
-     * @post `bool(*this)` returns true if opening succeeds.
-     */
-    void open(std::string filename)
+    HtmlGraphRenderer&& encoding(PayloadEncoding encoding) &&
     {
-        m_filename = std::move(filename);
-        m_file.open(m_filename);
-        if (!m_file) {
-            throw std::runtime_error("Cannot render ouput to " + m_filename);
-        }
-
-        // clang-format off
-        m_file <<
-            "<!doctype html>\n"
-            "<html>\n"
-            "  <head>\n"
-            // The version number may need to change from time to time
-            "    <script src=\"https://cdn.plot.ly/plotly-3.0.1.min.js\"></script>\n"
-            "  </head>\n"
-            "  <body>\n"
-            ;
-        // clang-format on
+        m_encoding = encoding;
+        return std::move(*this);
     }
-
-    /**
-     * Destructor.
-     * Closes the HTML tags and the file -- if opened.
-     * @throw none
-     */
-    ~HtmlGraphRenderer()
+    HtmlGraphRenderer& encoding(PayloadEncoding encoding) &
     {
-        if (!m_file.is_open()) return;
-        assert(m_file);
-        // clang-format off
-        m_file <<
-            "  </body>\n"
-            "</html>\n"
-            ;
-        // clang-format on
-        // std::cout << doctest::Color::Cyan <<"[nanobench]" << doctest::Color::None << " Rendered to " << m_filename << std::endl;
+        m_encoding = encoding;
+        return *this;
     }
 
-    /** Tells whether an opened file has been associated to the
-     * instance.
-     */
-    [[nodiscard]]
-    explicit operator bool()
+    HtmlGraphRenderer&& metrics(std::vector<Metric> metrics) &&
     {
-        return bool(m_file);
+        assert(!metrics.empty());
+        m_metrics = std::move(metrics);
+        return std::move(*this);
+    }
+    HtmlGraphRenderer& metrics(std::vector<Metric> metrics) &
+    {
+        assert(!metrics.empty());
+        m_metrics = std::move(metrics);
+        return *this;
     }
 
-    /** Getter to the associated file. */
-    [[nodiscard]]
-    std::ostream& stream()
+    HtmlGraphRenderer&& peakbandwidth(double bytes_per_second, std::string label = "peak") &&
     {
-        return m_file;
+        m_peak_bandwidth = bytes_per_second;
+        m_peak_label     = std::move(label);
+        return std::move(*this);
+    }
+    HtmlGraphRenderer& peakbandwidth(double bytes_per_second, std::string label = "peak") &
+    {
+        m_peak_bandwidth = bytes_per_second;
+        m_peak_label     = std::move(label);
+        return *this;
+    }
+
+    HtmlGraphRenderer&& showcontext(std::vector<std::string> names) &&
+    {
+        m_context = std::move(names);
+        return std::move(*this);
+    }
+    HtmlGraphRenderer& showcontext(std::vector<std::string> names) &
+    {
+        m_context = std::move(names);
+        return *this;
+    }
+
+    HtmlGraphRenderer&& groupby(std::string name) &&
+    {
+        m_group_by = std::move(name);
+        return std::move(*this);
+    }
+    HtmlGraphRenderer& groupby(std::string name) &
+    {
+        m_group_by = std::move(name);
+        return *this;
+    }
+
+    HtmlGraphRenderer&& baseline(baseline_lookup lookup) &&
+    {
+        m_baseline = std::move(lookup);
+        return std::move(*this);
+    }
+    HtmlGraphRenderer& baseline(baseline_lookup lookup) &
+    {
+        m_baseline = std::move(lookup);
+        return *this;
+    }
+
+    HtmlGraphRenderer&& topdown(topdown_lookup lookup) &&
+    {
+        m_topdown = std::move(lookup);
+        return std::move(*this);
+    }
+    HtmlGraphRenderer& topdown(topdown_lookup lookup) &
+    {
+        m_topdown = std::move(lookup);
+        return *this;
+    }
+
+    HtmlGraphRenderer&& deferred(bool do_defer) &&
+    {
+        m_deferred = do_defer;
+        return std::move(*this);
+    }
+    HtmlGraphRenderer& deferred(bool do_defer) &
+    {
+        m_deferred = do_defer;
+        return *this;
+    }
+
+    HtmlGraphRenderer&& lazyplots(bool do_lazy) &&
+    {
+        m_lazy = do_lazy;
+        return std::move(*this);
+    }
+    HtmlGraphRenderer& lazyplots(bool do_lazy) &
+    {
+        m_lazy = do_lazy;
+        return *this;
+    }
+
+    HtmlGraphRenderer&& purgeoffscreen(bool do_purge) &&
+    {
+        m_purge_offscreen = do_purge;
+        return std::move(*this);
+    }
+    HtmlGraphRenderer& purgeoffscreen(bool do_purge) &
+    {
+        m_purge_offscreen = do_purge;
+        return *this;
+    }
+
+    HtmlGraphRenderer&& plotlyurl(std::string url) &&
+    {
+        m_plotly_url = std::move(url);
+        return std::move(*this);
+    }
+    HtmlGraphRenderer& plotlyurl(std::string url) &
+    {
+        m_plotly_url = std::move(url);
+        return *this;
+    }
+
+#  if defined(NANOBENCH_HTML_GRAPH_USE_ZLIB)
+    HtmlGraphRenderer&& compress(bool do_compress) &&
+    {
+        m_compress = do_compress;
+        return std::move(*this);
+    }
+    HtmlGraphRenderer& compress(bool do_compress) &
+    {
+        m_compress = do_compress;
+        return *this;
+    }
+#  endif
+#endif
+
+    /**
+     * Opens the output HTML file and starts filling it.
+     * Tries to open `filename`. An exception is thrown if not possible.
+     * Otherwise, HTML header and `<body>` are automatically filled.
+     * @param[in] filename  Output HTML filename.
+     * @throw std::runtime_error is `filename` cannot be opened.
+     * @post `bool(*this)` returns true if opening succeeds.
+     */
+    void open(std::string filename)
+    {
+        m_filename = std::move(filename);
+        m_file.open(m_filename);
+        if (!m_file) {
+            throw std::runtime_error("Cannot render ouput to " + m_filename);
+        }
+
+        m_file << html_head("", "    <script>\n" + std::string(helpers_script) + "    </script>\n");
+    }
+
+    /**
+     * Opens a directory where the plots are written to several pages,
+     * listed in an `index.html` page with the median and error of each
+     * result.
+     * A new page is started by `page()`, or every `plots_per_page` plots.
+     * The pages and the index are written as soon as a page is complete,
+     * and they share the same scripts: the helpers in `nanobench.js`,
+     * and plotly, see `plotlyurl()`.
+     * @param[in] directory       Output directory, created if needed.
+     * @param[in] plots_per_page  0 for a new page only on `page()`.
+     * @throw std::runtime_error if the directory cannot be written.
+     * @throw std::filesystem::filesystem_error if it cannot be created.
+     */
+    void open_pages(std::string directory, std::size_t plots_per_page = 0)
+    {
+        std::filesystem::create_directories(directory);
+        m_pages                 = std::make_unique<pages_state>();
+        m_pages->directory      = directory;
+        m_pages->plots_per_page = plots_per_page;
+        m_filename              = std::move(directory);
+
+        std::ofstream helpers(m_pages->directory / "nanobench.js");
+        if (!helpers) {
+            throw std::runtime_error("Cannot render ouput to " + m_filename);
+        }
+        helpers << helpers_script;
+    }
+
+    /** Tells whether the output has been opened with `open_pages()`. */
+    [[nodiscard]]
+    bool paged() const noexcept
+    {
+        return m_pages != nullptr;
+    }
+
+    /**
+     * Starts a new page titled `title`, with `open_pages()`. When pages
+     * have a fixed number of plots, only the title of the next page is
+     * changed. Nothing is done otherwise.
+     * @note In deferred mode, the page starts when the plots rendered
+     * before have been written, in `flush()`.
+     * @note This function can be called concurrently, see `render_to()`.
+     */
+    void page(std::string title)
+    {
+        if (!m_pages) return;
+        if (m_deferred) {
+            enqueue([title = std::move(title)](HtmlGraphRenderer& self) { self.start_page(title); });
+        } else {
+            std::lock_guard lock(m_sync->write_mutex);
+            start_page(title);
+        }
+    }
+
+    /**
+     * Writes `html` before the plots, e.g. a description of the host.
+     * With `open_pages()`, it's written at the top of the index.
+     */
+    void preamble(std::string const& html)
+    {
+        std::lock_guard lock(m_sync->write_mutex);
+        if (m_pages) {
+            m_pages->preamble += html;
+        } else {
+            m_file << html;
+        }
+    }
+
+    /**
+     * Makes the pages of a child process distinct from those of its
+     * parent, with `open_pages()`: they are named after `page_prefix`,
+     * and they are listed in `index_file` instead of the index. The
+     * parent lists them with `append_pages_fragment()`.
+     * @pre The page inherited from the parent has been `detach()`ed.
+     */
+    void pages_fragment(std::string index_file, std::string page_prefix)
+    {
+        assert(m_pages && !m_file.is_open());
+        m_pages->index_fragment = std::move(index_file);
+        m_pages->prefix         = std::move(page_prefix);
+        m_pages->pages.clear();
+    }
+
+    /**
+     * Lists the pages written by a child process in the index.
+     * @param[in] filename  Index fragment, see `pages_fragment()`.
+     * @throw std::runtime_error is `filename` cannot be read, or the
+     *        index cannot be written.
+     */
+    void append_pages_fragment(std::string const& filename)
+    {
+        std::ifstream fragment(filename);
+        if (!fragment) {
+            throw std::runtime_error("Cannot read rendered fragment " + filename);
+        }
+        std::lock_guard lock(m_sync->write_mutex);
+        auto&           pages = m_pages->pages;
+        // Written by append_number()
+        auto const number = [](std::string const& s) {
+            return s == "null" ? std::numeric_limits<double>::quiet_NaN() : std::strtod(s.c_str(), nullptr);
+        };
+        for (std::string line; std::getline(fragment, line);) {
+            std::vector<std::string> fields;
+            for (std::size_t first = 0, tab; first <= line.size(); first = tab + 1) {
+                tab = std::min(line.find('\t', first), line.size());
+                fields.push_back(line.substr(first, tab - first));
+            }
+            if (fields[0] == "page" && fields.size() == 3) {
+                pages.push_back({fields[1], fields[2], {}});
+            } else if (fields[0] == "plot" && fields.size() == 3 && !pages.empty()) {
+                pages.back().plots.push_back({fields[1], fields[2], {}});
+            } else if (fields[0] == "result" && fields.size() == 4 && !pages.empty() && !pages.back().plots.empty()) {
+                pages.back().plots.back().results.push_back(
+                        {fields[1], number(fields[2]), number(fields[3])});
+            }
+        }
+        write_index();
+    }
+
+    /**
+     * Opens a file that only receives plots, without HTML header nor
+     * footer.
+     * Such fragments are produced by the processes that run benchmarks in
+     * parallel, and merged afterward with `append_fragment()`.
+     * @param[in] filename  Output fragment filename.
+     * @throw std::runtime_error is `filename` cannot be opened.
+     * @post `bool(*this)` returns true if opening succeeds.
+     */
+    void open_fragment(std::string filename)
+    {
+        m_fragment = true;
+        m_filename = std::move(filename);
+        m_file.open(m_filename);
+        if (!m_file) {
+            throw std::runtime_error("Cannot render ouput to " + m_filename);
+        }
+    }
+
+    /**
+     * Closes the file, without writing the HTML footer nor the
+     * deferred plots.
+     * Meant to release, in a child process, a file inherited from its
+     * parent.
+     * @pre The file has been flushed before the child was created.
+     */
+    void detach() noexcept
+    {
+        m_file.close();
+    }
+
+    /**
+     * Appends the content of a fragment file to the output file.
+     * @param[in] filename  Fragment filename, see `open_fragment()`.
+     * @throw std::runtime_error is `filename` cannot be read.
+     */
+    void append_fragment(std::string const& filename)
+    {
+        std::ifstream fragment(filename);
+        if (!fragment) {
+            throw std::runtime_error("Cannot read rendered fragment " + filename);
+        }
+        std::lock_guard lock(m_sync->write_mutex);
+        if (fragment.peek() != std::ifstream::traits_type::eof()) {
+            m_file << fragment.rdbuf();
+        }
+    }
+
+    /**
+     * Destructor.
+     * Writes the deferred plots, and closes the HTML tags and the file
+     * -- if opened.
+     * @throw none
+     */
+    ~HtmlGraphRenderer()
+    {
+        if (!m_file.is_open() && !m_pages) return;
+        try {
+            flush();
+        } catch (std::exception const& e) {
+            std::cerr << "Cannot render deferred plots to " << m_filename << ": " << e.what() << "\n";
+        }
+        try {
+            close();
+        } catch (std::exception const& e) {
+            std::cerr << "Cannot complete " << m_filename << ": " << e.what() << "\n";
+        }
+        // std::cout << doctest::Color::Cyan <<"[nanobench]" << doctest::Color::None << " Rendered to " << m_filename << std::endl;
+    }
+
+    /**
+     * Writes the deferred plots, and closes the HTML tags and the file.
+     * With `open_pages()`, the last page is closed, and the index -- or
+     * the index fragment of a child process -- is written.
+     * It's automatically called from the destructor.
+     * @throw std::bad_alloc if memory is exhausted.
+     * @throw std::runtime_error if the index cannot be written.
+     */
+    void close()
+    {
+        flush();
+        std::lock_guard lock(m_sync->write_mutex);
+        if (m_pages) {
+            close_page();
+            if (m_pages->index_fragment.empty()) {
+                write_index();
+            } else {
+                write_index_fragment();
+            }
+            m_pages.reset();
+            return;
+        }
+        if (!m_file.is_open()) return;
+        assert(m_file);
+        // clang-format off
+        if (!m_fragment) m_file <<
+            "  </body>\n"
+            "</html>\n"
+            ;
+        // clang-format on
+        m_file.close();
+    }
+
+    /** Tells whether an opened file has been associated to the
+     * instance.
+     */
+    [[nodiscard]]
+    explicit operator bool()
+    {
+        return bool(m_file);
+    }
+
+    /** Getter to the associated file. */
+    [[nodiscard]]
+    std::ostream& stream()
+    {
+        return m_file;
     }
 
     /**
-     * Appends {{mustache}} template in the file to render the select
-     * benchmark.
-     * @tparam Strings  Extra parameters forwarded to `skeleton()`.
+     * Appends the plot of the select benchmark to the file.
+     * @tparam Strings  Optional name of the HTML `<div/>` -- different
+     *                  for each benchmark --, and plot type overriding
+     *                  the one set in the constructor.
      * @param[in] b  nanobench micro-benchmark to render as graph.
-     * @param[in] s  Extra parameters to forward to `skeleton()`
+     * @param[in] s  `<div/>` name and plot type.
      *
      * @throw std::bad_alloc if memory is exhausted.
-     * @throw AnyThing that `ankerl::nanobench::render()` may throw.
      *
      * @pre This function needs to be called after all the
      * micro-benchmarks have been executed.
+     * @note In deferred mode, `b` is only copied, and the rendering
+     * happens in `flush()`.
+     * @note This function can be called concurrently. In deferred mode,
+     * no lock is taken.
      */
     template <typename... Strings>
     void render_to(ankerl::nanobench::Bench const& b, Strings const&... s)
     {
-        render(skeleton(s...), b, stream());
+        if (m_deferred) {
+            enqueue([b, args = std::make_tuple(std::string(s)...)](HtmlGraphRenderer& self) {
+                std::apply([&](auto const&... a) { self.write_to(b, a...); }, args);
+            });
+        } else {
+            std::lock_guard lock(m_sync->write_mutex);
+            write_to(b, s...);
+        }
     }
 
-private:
-
     /**
-     * Internal function that returns the mustache template for the
-     * current benchmark.
-     * @param[in] id         Name for the HTML `<div/>` that will be
-     *                       created for the current benchmark.
-     * @param[in] plot_type  "violin" or "box". Permits to override
-     *                       locally the plot type set in the class
-     *                       constructor.
+     * Appends a line plot of result medians to the file.
      *
-     * @return A {{mustache}} template that will be filled by
-     *         `ankerl::nanobench::render()`
-     * @throw std::bad_alloc if string cannot be created. Unlikely.
+     * Each series only covers a subset of the results.
+     * @param[in] b     nanobench micro-benchmark whose results are plotted.
+     * @param[in] plot  Description of the series and markers to draw.
+     * @param[in] id    Name for the HTML `<div/>`, different for each
+     *                  benchmark.
      *
-     * @pre `id` has to be different for each benchmark.
+     * @throw std::bad_alloc if memory is exhausted.
+     * @throw std::out_of_range if a series refers to a result that
+     *        doesn't exist.
+     * @note This function can be called concurrently, see `render_to()`.
+     */
+    void render_lines_to(
+            ankerl::nanobench::Bench const& b, LinePlot const& plot, std::string const& id)
+    {
+        if (m_deferred) {
+            enqueue([b, plot, id](HtmlGraphRenderer& self) { self.write_lines_to(b, plot, id); });
+        } else {
+            std::lock_guard lock(m_sync->write_mutex);
+            write_lines_to(b, plot, id);
+        }
+    }
+
+    /**
+     * Appends grouped violins -- or boxes -- of raw samples to the file,
+     * e.g. results read back from several sidecars.
      *
-     * @see `ankerl::nanobench::render()` for a complete list of all
-     * possible tags
-     * https://nanobench.ankerl.com/reference.html#_CPPv4N6ankerl9nanobench6renderEPKcRK5BenchRNSt7ostreamE
+     * Traces with the same name are drawn side by side, one per group,
+     * and each group has its own color.
+     * @param[in] plot  Traces to draw.
+     * @param[in] id    Name for the HTML `<div/>`.
+     *
+     * @throw std::bad_alloc if memory is exhausted.
+     * @note This function can be called concurrently, see `render_to()`.
      */
-    [[nodiscard]]
-    std::string skeleton(std::string const& id = "mydiv", std::string const& plot_type = "") const
+    void render_violins_to(ViolinPlot const& plot, std::string const& id)
     {
-        std::string const& type = !empty(plot_type) ? plot_type : m_plot_type;
-        // clang-format off
-        return "    <div id='" + id + "'>\n"
+        if (m_deferred) {
+            enqueue([plot, id](HtmlGraphRenderer& self) { self.write_violins_to(plot, id); });
+        } else {
+            std::lock_guard lock(m_sync->write_mutex);
+            write_violins_to(plot, id);
+        }
+    }
+
+    /**
+     * Writes the plots captured in deferred mode.
+     * Plots from every thread are written in the order `render_to()` was
+     * called.
+     * It's automatically called from the destructor. Calling it earlier,
+     * e.g. once all the test cases have been run, permits to report
+     * errors.
+     * @throw std::bad_alloc if memory is exhausted.
+     */
+    void flush()
+    {
+        std::lock_guard lock(m_sync->write_mutex);
+        std::vector<std::unique_ptr<pending_plot>> pending;
+        for (auto* p = m_sync->head.exchange(nullptr, std::memory_order_acquire); p; p = p->next) {
+            pending.emplace_back(p);
+        }
+        std::sort(pending.begin(), pending.end(), [](auto const& l, auto const& r) {
+            return l->ticket < r->ticket;
+        });
+        for (auto& p : pending) {
+            p->write(*this);
+        }
+        m_file.flush();
+    }
+
+private:
+
+    struct pending_plot
+    {
+        std::function<void(HtmlGraphRenderer&)> write;
+        std::uint64_t                           ticket;
+        pending_plot*                           next;
+    };
+
+    /**
+     * Synchronization state.
+     * Deferred plots are pushed to a lock-free list, and ordered by
+     * ticket when flushed. The file is protected by a mutex.
+     * It's kept behind a pointer for `HtmlGraphRenderer` to stay moveable.
+     */
+    struct sync_state
+    {
+        std::atomic<pending_plot*> head{nullptr};
+        std::atomic<std::uint64_t> tickets{0};
+        std::mutex                 write_mutex;
+
+        ~sync_state()
+        {
+            for (auto* p = head.load(); p;) {
+                delete std::exchange(p, p->next);
+            }
+        }
+    };
+
+    void enqueue(std::function<void(HtmlGraphRenderer&)> write)
+    {
+        auto* p = new pending_plot{
+            std::move(write), m_sync->tickets.fetch_add(1, std::memory_order_relaxed),
+            m_sync->head.load(std::memory_order_relaxed)};
+        while (!m_sync->head.compare_exchange_weak(
+                p->next, p, std::memory_order_release, std::memory_order_relaxed)) {
+        }
+    }
+
+    /**
+     * State of `open_pages()`: what the index lists of the pages written
+     * so far.
+     */
+    struct pages_state
+    {
+        struct result_entry
+        {
+            std::string name;
+            double      median; ///< Elapsed time per unit
+            double      error;
+        };
+        struct plot_entry
+        {
+            std::string               id;
+            std::string               title;
+            std::vector<result_entry> results;
+        };
+        struct page_entry
+        {
+            std::string             file;
+            std::string             title;
+            std::vector<plot_entry> plots;
+        };
+
+        std::filesystem::path   directory;
+        std::size_t             plots_per_page = 0;
+        std::string             prefix         = "page-";
+        std::string             index_fragment;
+        std::string             next_title;
+        std::string             preamble;
+        std::vector<page_entry> pages;
+    };
+
+    /** Actual implementation of `page()`. */
+    void start_page(std::string const& title)
+    {
+        m_pages->next_title = title;
+        if (m_pages->plots_per_page == 0) close_page();
+    }
+
+    /**
+     * Records a plot in the index, with the medians of `b` if any, and
+     * opens a new page if needed.
+     * Nothing is done without `open_pages()`.
+     * @throw std::runtime_error if the page cannot be written.
+     */
+    void start_plot(std::string const& id, std::string const& title, ankerl::nanobench::Bench const* b)
+    {
+        if (!m_pages) return;
+        if (!m_file.is_open()
+                || (m_pages->plots_per_page > 0 && m_pages->pages.back().plots.size() >= m_pages->plots_per_page)) {
+            open_page();
+        }
+        auto& plot = m_pages->pages.back().plots.emplace_back();
+        plot.id    = id;
+        plot.title = title;
+        if (!b) return;
+        using Measure = ankerl::nanobench::Result::Measure;
+        for (auto const& r : b->results()) {
+            plot.results.push_back(
+                    {r.config().mBenchmarkName, median_per_unit(r), r.medianAbsolutePercentError(Measure::elapsed)});
+        }
+    }
+
+    void open_page()
+    {
+        close_page();
+        std::string const number = std::to_string(m_pages->pages.size() + 1);
+        auto&             page   = m_pages->pages.emplace_back();
+        page.file  = m_pages->prefix + std::string(number.size() < 4 ? 4 - number.size() : 0, '0') + number + ".html";
+        page.title = !m_pages->next_title.empty() ? m_pages->next_title : "Page " + number;
+        m_file.open(m_pages->directory / page.file);
+        if (!m_file) {
+            throw std::runtime_error("Cannot render ouput to " + (m_pages->directory / page.file).string());
+        }
+        m_file << html_head(page.title, "    <script src=\"nanobench.js\"></script>\n")
+               << "    <p><a href=\"index.html\">Index</a></p>\n"
+               << "    <h1>" << html_escape(page.title) << "</h1>\n";
+    }
+
+    /** Closes the current page, if any, and updates the index. */
+    void close_page()
+    {
+        if (!m_file.is_open()) return;
+        m_file << "  </body>\n</html>\n";
+        m_file.close();
+        if (m_pages->index_fragment.empty()) write_index();
+    }
+
+    /**
+     * Writes `index.html`: a table per page, with a link to each plot and
+     * the median time per unit and error of each result.
+     */
+    void write_index() const
+    {
+        std::ofstream index(m_pages->directory / "index.html");
+        if (!index) {
+            throw std::runtime_error("Cannot render ouput to " + (m_pages->directory / "index.html").string());
+        }
+        index << "<!doctype html>\n<html>\n  <head>\n    <title>Benchmarks</title>\n  </head>\n  <body>\n"
+              << m_pages->preamble;
+        for (auto const& page : m_pages->pages) {
+            index << "    <h2><a href=\"" << page.file << "\">" << html_escape(page.title) << "</a></h2>\n"
+                  << "    <table border=\"1\" style=\"border-collapse: collapse; font-family: sans-serif\">\n"
+                  << "      <tr><th>benchmark</th><th>result</th><th>median per unit</th><th>error</th></tr>\n";
+            for (auto const& plot : page.plots) {
+                std::string const link = "<a href=\"" + page.file + "#" + html_escape(plot.id) + "\">"
+                    + html_escape(plot.title) + "</a>";
+                if (plot.results.empty()) {
+                    index << "      <tr><td>" << link << "</td><td></td><td></td><td></td></tr>\n";
+                }
+                for (auto const& r : plot.results) {
+                    char error[32];
+                    std::snprintf(error, sizeof(error), "%.2f%%", 100 * r.error);
+                    index << "      <tr><td>" << link << "</td><td>" << html_escape(r.name) << "</td><td>"
+                          << format_duration(r.median) << "</td><td>" << error << "</td></tr>\n";
+                }
+            }
+            index << "    </table>\n";
+        }
+        index << "  </body>\n</html>\n";
+    }
+
+    /**
+     * Writes the index entries of a child process, one per line: `page`,
+     * `plot`, and `result` followed by their tab-separated fields.
+     */
+    void write_index_fragment() const
+    {
+        std::ofstream out(m_pages->index_fragment);
+        if (!out) {
+            throw std::runtime_error("Cannot render ouput to " + m_pages->index_fragment);
+        }
+        auto const field = [](std::string s) {
+            std::replace_if(s.begin(), s.end(), [](char c) { return c == '\t' || c == '\n'; }, ' ');
+            return '\t' + s;
+        };
+        for (auto const& page : m_pages->pages) {
+            out << "page" << field(page.file) << field(page.title) << "\n";
+            for (auto const& plot : page.plots) {
+                out << "plot" << field(plot.id) << field(plot.title) << "\n";
+                for (auto const& r : plot.results) {
+                    std::string values;
+                    append_number(values, r.median);
+                    values += '\t';
+                    append_number(values, r.error);
+                    out << "result" << field(r.name) << '\t' << values << "\n";
+                }
+            }
+        }
+    }
+
+    /** Duration in seconds, with 3 significant digits and a unit. */
+    static std::string format_duration(double seconds)
+    {
+        static constexpr std::pair<double, char const*> units[] = {
+            {1, "s"}, {1e-3, "ms"}, {1e-6, "us"}, {1e-9, "ns"}};
+        auto const& unit = *std::find_if(std::begin(units), std::end(units) - 1, [&](auto const& u) {
+            return seconds >= u.first;
+        });
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%.3g %s", seconds / unit.first, unit.second);
+        return buffer;
+    }
+
+    static std::string html_escape(std::string const& s)
+    {
+        std::string out;
+        for (char const c : s) {
+            switch (c) {
+                case '<': out += "&lt;"; break;
+                case '>': out += "&gt;"; break;
+                case '&': out += "&amp;"; break;
+                case '"': out += "&quot;"; break;
+                default:  out += c;
+            }
+        }
+        return out;
+    }
+
+    /**
+     * `<head/>` of the pages, and opening of their `<body/>`.
+     * @param[in] scripts  Where the helpers come from: either inline, or
+     *                     `nanobench.js`.
+     */
+    std::string html_head(std::string const& title, std::string const& scripts) const
+    {
+        return "<!doctype html>\n"
+            "<html>\n"
+            "  <head>\n"
+            + (title.empty() ? std::string() : "    <title>" + html_escape(title) + "</title>\n")
+            + "    <script src=\"" + m_plotly_url + "\"></script>\n"
+            + scripts
+            + "  </head>\n"
+            "  <body>\n";
+    }
+
+    // clang-format off
+    /** JavaScript helpers the plots rely on. */
+    static constexpr char const* helpers_script =
+        // Decoder for PayloadEncoding::float32/float64 measurements
+        "      async function nbDecode(b64, type, compressed) {\n"
+        "        var bytes = Uint8Array.from(atob(b64), c => c.charCodeAt(0));\n"
+        "        if (compressed) {\n"
+        "          var stream = new Blob([bytes]).stream().pipeThrough(new DecompressionStream('deflate'));\n"
+        "          bytes = new Uint8Array(await new Response(stream).arrayBuffer());\n"
+        "        }\n"
+        "        return type === 'f32' ? new Float32Array(bytes.buffer) : new Float64Array(bytes.buffer);\n"
+        "      }\n"
+        // Lazy plots: drawn when scrolled into view, optionally purged when they leave it
+        "      var nbObserver = null;\n"
+        "      var nbPlots = {};\n"
+        "      function nbRegister(id, draw, options) {\n"
+        "        if (typeof IntersectionObserver === 'undefined') { draw(); return; }\n"
+        "        if (!nbObserver) {\n"
+        "          nbObserver = new IntersectionObserver(entries => {\n"
+        "            for (const e of entries) {\n"
+        "              const p = nbPlots[e.target.id];\n"
+        "              if (e.isIntersecting && !p.drawn) {\n"
+        "                p.drawn = true;\n"
+        "                p.draw();\n"
+        "              } else if (!e.isIntersecting && p.drawn && p.purge) {\n"
+        "                p.drawn = false;\n"
+        "                Plotly.purge(e.target);\n"
+        "              }\n"
+        "            }\n"
+        "          }, { rootMargin: '200px' });\n"
+        "        }\n"
+        "        nbPlots[id] = { draw: draw, drawn: false, purge: options.purge };\n"
+        "        nbObserver.observe(document.getElementById(id));\n"
+        "      }\n"
+        ;
+    // clang-format on
+
+    /** Actual implementation of `render_to()`. */
+    template <typename... Strings>
+    void write_to(ankerl::nanobench::Bench const& b, Strings const&... s)
+    {
+        std::string id = "mydiv";
+        if constexpr (sizeof...(s) > 0) id = std::get<0>(std::tie(s...));
+        start_plot(id, b.title(), &b);
+        render_native_to(b, s...);
+        if (m_timeseries) {
+            write_timeseries_to(b, id + "-epochs");
+        }
+    }
+
+    /**
+     * Elapsed times of each result of `b` in epoch order, with their
+     * rolling median and changepoints. See `timeseries()`.
+     */
+    void write_timeseries_to(ankerl::nanobench::Bench const& b, std::string const& id)
+    {
+        bool const  encoded = m_encoding != PayloadEncoding::text;
+        std::string out     = plot_prologue(id, encoded) + "        var data = [\n";
+        std::string shapes;
+        for (std::size_t j = 0; j < b.results().size(); ++j) {
+            auto const&               r       = b.results()[j];
+            std::string const         name    = r.config().mBenchmarkName;
+            std::string const         color   = plotly_color(j);
+            std::string const         group   = js_string("r" + std::to_string(j));
+            std::vector<double> const samples = metric_samples(r, Metric::elapsed, 1);
+            std::vector<double> const medians = rolling_median(samples, std::max<std::size_t>(3, (samples.size() / 10) | 1));
+            std::vector<std::size_t> const changes = changepoints(samples);
+
+            out += "            {\n"
+                "                name: " + js_string(name) + ", mode: 'markers', legendgroup: " + group + ",\n"
+                "                marker: { color: '" + color + "', size: 4, opacity: 0.5 },\n"
+                "                y: ";
+            append_samples(out, samples);
+            out += ",\n"
+                "            },\n"
+                "            {\n"
+                "                name: " + js_string(name + " rolling median (" + std::to_string(changes.size())
+                        + (changes.size() == 1 ? " change)" : " changes)"))
+                + ", mode: 'lines', legendgroup: " + group + ",\n"
+                "                line: { color: '" + color + "' },\n"
+                "                y: ";
+            append_samples(out, medians);
+            out += ",\n"
+                "            },\n";
+            if (changes.empty()) continue;
+
+            std::string x, y;
+            for (auto const c : changes) {
+                x += x.empty() ? "" : ", ";
+                append_number(x, double(c));
+                y += y.empty() ? "" : ", ";
+                append_number(y, medians[c]);
+                shapes += "{ type: 'line', xref: 'x', yref: 'paper', x0: ";
+                append_number(shapes, double(c) - 0.5);
+                shapes += ", x1: ";
+                append_number(shapes, double(c) - 0.5);
+                shapes += ", y0: 0, y1: 1, line: { color: '" + color + "', dash: 'dot' } }, ";
+            }
+            out += "            {\n"
+                "                name: " + js_string(name + " changes") + ", mode: 'markers', legendgroup: " + group
+                + ", showlegend: false,\n"
+                "                marker: { color: '" + color + "', symbol: 'x', size: 12 },\n"
+                "                x: [" + x + "], y: [" + y + "],\n"
+                "            },\n";
+        }
+        out += "        ];\n"
+            "\n"
+            "        data = data.map(a => Object.assign(a, { type: 'scatter' }));\n"
+            "        var layout = { title: { text: " + js_string(b.title() + ", epochs in order") + " }, showlegend: "
+            + m_show_legend + ", xaxis: { title: { text: 'epoch' } }, yaxis: { title: { text: 'time per unit' }"
+            + m_range_mode + ", autorange: true }";
+        if (!shapes.empty()) out += ", shapes: [" + shapes + "]";
+        out += " };\n"
+            "        Plotly.newPlot('" + id + "', data, layout, {responsive: true});\n"
+            + plot_epilogue(encoded);
+        stream() << out;
+    }
+
+    /** Actual implementation of `render_lines_to()`. */
+    void write_lines_to(
+            ankerl::nanobench::Bench const& b, LinePlot const& plot, std::string const& id)
+    {
+        start_plot(id, b.title(), &b);
+        double max_throughput = 0;
+        for (auto const& series : plot.series) {
+            for (auto const i : series.results) {
+                double const elapsed = median_per_unit(b.results().at(i));
+                if (elapsed > 0) max_throughput = std::max(max_throughput, 1.0 / elapsed);
+            }
+        }
+        auto const [scale, prefix] = si_scale(max_throughput);
+
+        std::string out = plot_prologue(id, false)
+            + "        var data = [\n";
+        for (auto const& series : plot.series) {
+            out += "            { name: " + js_string(series.name) + ", mode: 'lines+markers', x: [";
+            for (std::size_t i = 0; i < series.x.size(); ++i) {
+                if (i) out += ", ";
+                append_number(out, series.x[i]);
+            }
+            out += "], y: [";
+            for (std::size_t i = 0; i < series.results.size(); ++i) {
+                if (i) out += ", ";
+                double const elapsed = median_per_unit(b.results().at(series.results[i]));
+                append_number(out, plot.throughput ? scale / elapsed : elapsed * plot.y_scale);
+            }
+            for (std::size_t i = 0; series.results.empty() && i < series.y.size(); ++i) {
+                if (i) out += ", ";
+                append_number(out, plot.throughput ? series.y[i] * scale : series.y[i]);
+            }
+            out += "]";
+            if (!series.dash.empty()) out += ", line: { dash: " + js_string(series.dash) + " }";
+            out += " },\n";
+        }
+        out += "        ];\n"
+            "        var shapes = [\n";
+        for (auto const& m : plot.markers) {
+            out += "            { type: 'line', xref: 'x', yref: 'paper', y0: 0, y1: 1, x0: ";
+            append_number(out, m.x);
+            out += ", x1: ";
+            append_number(out, m.x);
+            out += ", line: { dash: 'dot', color: 'grey' }, label: { text: " + js_string(m.label)
+                + ", textposition: 'end', textangle: 0, yanchor: 'top' } },\n";
+        }
+        for (auto const& m : plot.y_markers) {
+            out += "            { type: 'line', xref: 'paper', x0: 0, x1: 1, yref: 'y', y0: ";
+            append_number(out, m.x);
+            out += ", y1: ";
+            append_number(out, m.x);
+            out += ", line: { dash: 'dot', color: 'grey' }, label: { text: " + js_string(m.label)
+                + ", textposition: 'start', yanchor: 'bottom' } },\n";
+        }
+        if (plot.throughput && is_bytes(b.unit())) {
+            out += "            " + peak_shape("y", scale) + "\n";
+        }
+        out += "        ];\n"
+            "        var layout = { title: { text: " + js_string(b.title() + context_subtitle(b)) + " }, showlegend: " + m_show_legend
+            + ", shapes: shapes"
+            + ", xaxis: { title: { text: " + js_string(plot.x_title) + " }" + (plot.log_x ? ", type: 'log'" : "") + " }"
+            + ", yaxis: { title: { text: " + js_string(
+                    !plot.y_title.empty() ? plot.y_title
+                    : plot.throughput     ? throughput_title(b.unit(), prefix)
+                                          : "time per unit") + " }" + m_range_mode + ", autorange: true } };\n"
+            "        Plotly.newPlot('" + id + "', data, layout, {responsive: true});\n"
+            + plot_epilogue(false);
+        stream() << out;
+    }
+
+    /**
+     * Writes the plot of `b` straight from its results.
+     * The script is built in `m_buffer`, that keeps its capacity from one
+     * plot to the next: numbers are formatted with `std::to_chars()`,
+     * and strings are escaped in place.
+     */
+    void render_native_to(
+            ankerl::nanobench::Bench const& b, std::string const& id = "mydiv",
+            std::string const& plot_type = "")
+    {
+        using Measure = ankerl::nanobench::Result::Measure;
+        std::string const& type    = !empty(plot_type) ? plot_type : m_plot_type;
+
+        // Same SI prefix for all the results
+        double max_throughput = 0;
+        for (auto const& r : b.results()) {
+            double const elapsed = median_per_unit(r);
+            if (elapsed > 0) max_throughput = std::max(max_throughput, 1.0 / elapsed);
+        }
+        auto const [scale, prefix] = si_scale(max_throughput);
+        bool const show_peak_ratio = m_peak_bandwidth > 0 && is_bytes(b.unit())
+            && std::find(m_metrics.begin(), m_metrics.end(), Metric::throughput) != m_metrics.end();
+
+        // Value of the groupby() variable of each result, its baseline,
+        // and the distinct groups that choose the colors
+        std::size_t const                       nb_results = b.results().size();
+        std::vector<std::string>                groups(nb_results);
+        std::vector<std::string>                baseline_groups(nb_results);
+        std::vector<std::vector<double> const*> baselines(nb_results, nullptr);
+        std::vector<topdown_breakdown const*>   topdowns(nb_results, nullptr);
+        bool                                    grouped    = false;
+        bool                                    compared   = false;
+        bool                                    breakdowns = false;
+        for (std::size_t j = 0; j < nb_results; ++j) {
+            if (!m_group_by.empty()) grouped |= context_of(b.results()[j], m_group_by, groups[j]);
+            if (m_baseline) baselines[j] = m_baseline(b.title(), b.results()[j]);
+            if (m_topdown) topdowns[j] = m_topdown(b.title(), b.results()[j]);
+            compared |= baselines[j] != nullptr;
+            breakdowns |= topdowns[j] && !topdowns[j]->slots.empty();
+        }
+        // The top-down bars get their own subplot, under the metrics
+        std::size_t const rows   = m_metrics.size() + (breakdowns ? 1 : 0);
+        bool const        linked = rows > 1;
+        if (compared) {
+            // Baseline and current violins side by side
+            grouped = true;
+            for (std::size_t j = 0; j < nb_results; ++j) {
+                baseline_groups[j] = groups[j].empty() ? "baseline" : groups[j] + " baseline";
+                if (groups[j].empty()) groups[j] = "current";
+            }
+        }
+        std::vector<std::string> group_values;
+        for (std::size_t j = 0; j < nb_results; ++j) {
+            for (auto const* g : {&groups[j], &baseline_groups[j]}) {
+                if (!g->empty() && std::find(group_values.begin(), group_values.end(), *g) == group_values.end()) {
+                    group_values.push_back(*g);
+                }
+            }
+        }
+        // The baselines appear in the legend with the first metric they're drawn for
+        std::size_t first_baseline_metric = m_metrics.size();
+        for (std::size_t k = m_metrics.size(); k > 0; --k) {
+            if (has_baseline_samples(m_metrics[k - 1])) first_baseline_metric = k - 1;
+        }
+
+        // Common attributes of a trace: position, legend, and color
+        auto const group_index = [&](std::string const& group, std::size_t j) {
+            return grouped
+                ? std::size_t(std::find(group_values.begin(), group_values.end(), group) - group_values.begin())
+                : j;
+        };
+        auto const style = [&](std::string const& name, std::string const& group, std::string const& legend,
+                               bool show_legend, std::size_t k, std::size_t j) {
+            std::string const color = plotly_color(group_index(group, j));
+            std::string       res;
+            if (grouped) {
+                res += "                x0: " + js_string(name) + ", offsetgroup: " + js_string(group) + ",\n";
+            }
+            if (linked) {
+                res += "                legendgroup: '" + legend + "', showlegend: "
+                    + (show_legend ? "true" : "false") + ", yaxis: 'y" + (k ? std::to_string(k + 1) : "") + "',\n";
+            }
+            if (linked || grouped) {
+                res += "                marker: { color: '" + color + "' }, line: { color: '" + color + "' },\n";
+            }
+            return res;
+        };
+
+        // Precomputed violins are drawn on a numeric x-axis: each result,
+        // or each benchmark name when grouped, is at an integer position,
+        // and the groups share it as plotly does in 'group' mode
+        bool const               summarized = m_kde_points > 0;
+        std::vector<std::string> categories;
+        std::vector<std::size_t> positions(nb_results);
+        for (std::size_t j = 0; j < nb_results; ++j) {
+            std::string const& name = b.results()[j].config().mBenchmarkName;
+            auto               it   = std::find(categories.begin(), categories.end(), name);
+            if (!grouped || it == categories.end()) it = categories.insert(categories.end(), name);
+            positions[j] = std::size_t(it - categories.begin());
+        }
+        double const slot  = 0.8 / double(std::max<std::size_t>(group_values.size(), 1));
+        auto const   place = [&](std::string const& group, std::size_t j) {
+            double const g = grouped ? double(group_index(group, j)) : 0;
+            return double(positions[j]) + (g - double(std::max<std::size_t>(group_values.size(), 1) - 1) / 2) * slot;
+        };
+
+        std::string& out = m_buffer;
+        out.clear();
+        out += plot_prologue(id, m_encoding != PayloadEncoding::text);
+        out += "        var data = [\n";
+        std::string         label;
+        std::vector<double> samples;
+        for (std::size_t k = 0; k < m_metrics.size(); ++k) {
+            for (std::size_t j = 0; j < nb_results; ++j) {
+                auto const&        r    = b.results()[j];
+                std::string const& name = r.config().mBenchmarkName;
+                label.clear();
+                append_js_string(label, grouped ? name + " [" + groups[j] + "]" : name);
+                label += " + ' (error: ' + (100*";
+                append_number(label, r.medianAbsolutePercentError(Measure::elapsed));
+                label += ").toFixed(2) + '%";
+                if (m_show_epochs) {
+                    label += "; epochs: ";
+                    append_number(label, double(r.config().mNumEpochs));
+                }
+                if (topdowns[j] && !miss_text(*topdowns[j], b.unit()).empty()) {
+                    label += "' + ";
+                    append_js_string(label, miss_text(*topdowns[j], b.unit()));
+                    label += " + '";
+                }
+                if (show_peak_ratio && median_per_unit(r) > 0) {
+                    label += "; ";
+                    append_number(label, std::round(100 / median_per_unit(r) / m_peak_bandwidth));
+                    label += "% of ' + ";
+                    append_js_string(label, m_peak_label);
+                    label += " + '";
+                }
+                label += ")'";
+                metric_samples(r, m_metrics[k], scale, samples);
+                if (summarized) {
+                    out += summary_traces(samples, label, "r" + std::to_string(j),
+                            k == 0, k, place(groups[j], j), slot / 2, plotly_color(group_index(groups[j], j)));
+                } else {
+                    out += "            {\n"
+                        "                name: ";
+                    out += label;
+                    out += ",\n"
+                        "                y: ";
+                    append_samples(out, samples);
+                    out += ",\n";
+                    out += style(name, groups[j], "r" + std::to_string(j), k == 0, k, j);
+                    out += "            },\n";
+                }
+
+                if (baselines[j] && has_baseline_samples(m_metrics[k])) {
+                    samples = *baselines[j];
+                    if (m_metrics[k] == Metric::throughput) {
+                        for (auto& v : samples) v = scale / v;
+                    }
+                    std::string const baseline_label = js_string(name + " [" + baseline_groups[j] + "]");
+                    if (summarized) {
+                        out += summary_traces(samples, baseline_label, "b" + std::to_string(j),
+                                k == first_baseline_metric, k, place(baseline_groups[j], j), slot / 2,
+                                plotly_color(group_index(baseline_groups[j], j)));
+                        continue;
+                    }
+                    out += "            {\n"
+                        "                name: " + baseline_label + ",\n"
+                        "                y: ";
+                    append_samples(out, samples);
+                    out += ",\n"
+                        + style(name, baseline_groups[j], "b" + std::to_string(j), k == first_baseline_metric, k, j)
+                        + "            },\n";
+                }
+            }
+        }
+        out += "        ];\n"
+            "        var title = " + js_string(b.title() + context_subtitle(b)) + ";\n"
+            "\n";
+        if (!summarized) {
+            out += "        data = data.map(a => Object.assign(a, { boxpoints: 'all', pointpos: 0, type: '" + type + "', box: {visible: true}, meanline: {visible: true} }));\n";
+        }
+        if (breakdowns) {
+            // Bars at the category of their violins
+            std::vector<std::string> x(nb_results);
+            for (std::size_t j = 0; j < nb_results; ++j) {
+                if (summarized) {
+                    append_number(x[j], double(positions[j]));
+                } else {
+                    x[j] = grouped ? js_string(b.results()[j].config().mBenchmarkName)
+                                   : "data[" + std::to_string(j) + "].name";
+                }
+            }
+            out += topdown_traces(topdowns, x, grouped ? groups : std::vector<std::string>(nb_results),
+                    "y" + std::to_string(rows));
+        }
+        out += "        var layout = { title: { text: title }, showlegend: " + m_show_legend;
+        if (summarized) {
+            out += ", xaxis: { tickvals: [";
+            for (std::size_t c = 0; c < categories.size(); ++c) out += (c ? ", " : "") + std::to_string(c);
+            out += "], ticktext: [";
+            for (std::size_t c = 0; c < categories.size(); ++c) out += (c ? ", " : "") + js_string(categories[c]);
+            out += "], range: [-0.5, ";
+            append_number(out, double(categories.size()) - 0.5);
+            out += "], zeroline: false }";
+        } else if (grouped) {
+            out += ", violinmode: 'group', boxmode: 'group'";
+        }
+        if (breakdowns) {
+            out += ", barmode: 'group'";
+        }
+        if (linked) {
+            out += ", height: " + std::to_string(150 + 250 * rows)
+                + ", grid: { rows: " + std::to_string(rows) + ", columns: 1, pattern: 'coupled' }";
+        }
+        std::string shapes;
+        for (std::size_t k = 0; k < m_metrics.size(); ++k) {
+            std::string const axis = k ? std::to_string(k + 1) : "";
+            std::string const title
+                = m_metrics[k] == Metric::throughput ? throughput_title(b.unit(), prefix)
+                                                     : metric_title(m_metrics[k]);
+            out += ", yaxis" + axis + ": { title: " + js_string(title) + m_range_mode + ", autorange: true }";
+            if (m_metrics[k] == Metric::throughput && is_bytes(b.unit())) {
+                shapes += peak_shape("y" + axis, scale);
+            }
+        }
+        if (breakdowns) {
+            out += ", yaxis" + std::to_string(rows)
+                + ": { title: 'pipeline slots', range: [0, 1], tickformat: '.0%' }";
+        }
+        if (!shapes.empty()) out += ", shapes: [" + shapes + "]";
+        out += " };\n"
+            "        Plotly.newPlot('" + id + "', data, layout, {responsive: true});\n"
+            + plot_epilogue(m_encoding != PayloadEncoding::text);
+        stream() << out;
+    }
+
+    /**
+     * Stacked bars of the top-down breakdowns, one trace per component
+     * and group, pushed to the `data` of `render_native_to()`.
+     * Bars are stacked with explicit bases, as plotly cannot both group
+     * and stack bars: each group of results has its own offset, like its
+     * violins.
+     * @param[in] x       JavaScript expression of the x-axis category
+     *                    of each result, that of its violins.
+     * @param[in] groups  Group of each result, all empty when the
+     *                    violins aren't grouped.
+     */
+    static std::string topdown_traces(
+            std::vector<topdown_breakdown const*> const& topdowns, std::vector<std::string> const& x_values,
+            std::vector<std::string> const& groups, std::string const& axis)
+    {
+        // Components and groups in the order of their first appearance
+        std::vector<topdown_breakdown::Component const*> components;
+        std::vector<std::string>                         group_values;
+        for (std::size_t j = 0; j < topdowns.size(); ++j) {
+            if (!topdowns[j] || topdowns[j]->slots.empty()) continue;
+            for (auto const& c : topdowns[j]->slots) {
+                if (std::none_of(components.begin(), components.end(), [&](auto const* x) { return x->name == c.name; })) {
+                    components.push_back(&c);
+                }
+            }
+            if (std::find(group_values.begin(), group_values.end(), groups[j]) == group_values.end()) {
+                group_values.push_back(groups[j]);
+            }
+        }
+
+        std::string out;
+        for (std::size_t c = 0; c < components.size(); ++c) {
+            std::string const color = components[c]->color.empty() ? plotly_color(c) : components[c]->color;
+            for (std::size_t g = 0; g < group_values.size(); ++g) {
+                std::string x, y, base;
+                for (std::size_t j = 0; j < topdowns.size(); ++j) {
+                    if (!topdowns[j] || topdowns[j]->slots.empty() || groups[j] != group_values[g]) continue;
+                    double fraction = 0, below = 0;
+                    for (auto const& slot : topdowns[j]->slots) {
+                        if (slot.name == components[c]->name) {
+                            fraction = slot.fraction;
+                            break;
+                        }
+                        below += slot.fraction;
+                    }
+                    x += (x.empty() ? "" : ", ") + x_values[j];
+                    y += y.empty() ? "" : ", ";
+                    append_number(y, fraction);
+                    base += base.empty() ? "" : ", ";
+                    append_number(base, below);
+                }
+                out += "        data.push({ type: 'bar', name: " + js_string(components[c]->name)
+                    + ", x: [" + x + "], y: [" + y + "], base: [" + base + "],\n"
+                    "            hovertemplate: '%{y:.1%}', offsetgroup: "
+                    + js_string(group_values[g].empty() ? "topdown" : group_values[g])
+                    + ", yaxis: '" + axis + "', legendgroup: 'td" + std::to_string(c) + "', showlegend: "
+                    + (g == 0 ? "true" : "false") + ", marker: { color: '" + color + "' } });\n";
+            }
+        }
+        return out;
+    }
+
+    /**
+     * Violin precomputed from `samples`, pushed to the `data` of
+     * `render_native_to()`: its density as a filled outline, and its box
+     * with the statistics of the summary. See `summarize()`.
+     * @param[in] label      JavaScript expression of the trace name.
+     * @param[in] x          Position of the violin on the x-axis.
+     * @param[in] halfwidth  Half width of the widest part of the violin.
+     */
+    std::string summary_traces(
+            std::vector<double> const& samples, std::string const& label, std::string const& legend,
+            bool show_legend, std::size_t k, double x, double halfwidth, std::string const& color) const
+    {
+        violin_summary const s = summarize_violin(samples, m_kde_points);
+        if (s.y.empty()) return "";
+        double const peak = *std::max_element(s.density.begin(), s.density.end());
+        double const zoom = peak > 0 ? halfwidth * 0.95 / peak : 0;
+
+        // Right side upwards, then left side downwards
+        std::string xs, ys;
+        std::size_t const n = s.y.size();
+        for (std::size_t i = 0; i < 2 * n; ++i) {
+            std::size_t const at = i < n ? i : 2 * n - 1 - i;
+            xs += i ? ", " : "";
+            append_number(xs, x + (i < n ? 1 : -1) * zoom * s.density[at]);
+            ys += i ? ", " : "";
+            append_number(ys, s.y[at]);
+        }
+        std::string const placement = "legendgroup: '" + legend + "', yaxis: 'y" + (k ? std::to_string(k + 1) : "")
+            + "',\n";
+        std::string const attributes = placement
+            + "                marker: { color: '" + color + "' }, line: { color: '" + color + "', width: 1 },\n";
+
+        std::string out = "            {\n"
+            "                type: 'scatter', mode: 'lines', fill: 'toself', hoveron: 'fills', name: " + label + ",\n"
+            "                showlegend: " + (show_legend ? "true" : "false") + ", " + attributes
+            + "                x: [" + xs + "],\n"
+            "                y: [" + ys + "],\n"
+            "            },\n"
+            "            {\n"
+            "                type: 'box', name: " + label + ", showlegend: false, boxmean: true, " + attributes
+            + "                x: [";
+        append_number(out, x);
+        out += "], width: ";
+        append_number(out, halfwidth / 2);
+        for (auto const& [key, value] : {std::pair{"q1", s.q1}, std::pair{"median", s.median}, std::pair{"q3", s.q3},
+                     std::pair{"lowerfence", s.lower_whisker}, std::pair{"upperfence", s.upper_whisker},
+                     std::pair{"mean", s.mean}}) {
+            out += std::string(", ") + key + ": [";
+            append_number(out, value);
+            out += "]";
+        }
+        out += ",\n"
+            "            },\n";
+        if (m_raw_points) {
+            out += "            {\n"
+                "                type: 'scatter', mode: 'markers', name: " + label + ", showlegend: false, hoverinfo: 'y', "
+                + placement + "                x: Array(" + std::to_string(samples.size()) + ").fill(";
+            append_number(out, x);
+            out += "), y: ";
+            append_samples(out, samples);
+            out += ", marker: { color: '" + color + "', size: 3 },\n"
+                "            },\n";
+        }
+        return out;
+    }
+
+    /** Cache misses of a breakdown, if measured, for the trace names. */
+    static std::string miss_text(topdown_breakdown const& t, std::string const& unit)
+    {
+        std::string out;
+        for (auto const& [label, value] : {std::pair{"L1D", t.l1d_misses}, std::pair{"LLC", t.llc_misses}}) {
+            if (!std::isfinite(value)) continue;
+            char buffer[64];
+            std::snprintf(buffer, sizeof(buffer), "; %s misses: %.3g/%s", label, value, unit.empty() ? "op" : unit.c_str());
+            out += buffer;
+        }
+        return out;
+    }
+
+    /** Axis title of `m`. */
+    static char const* metric_title(Metric m) noexcept
+    {
+        switch (m) {
+            case Metric::elapsed:               return "time per unit";
+            case Metric::cycles_per_unit:       return "cycles per unit";
+            case Metric::instructions_per_unit: return "instructions per unit";
+            case Metric::ipc:                   return "IPC";
+            case Metric::branch_miss_rate:      return "branch miss rate";
+            case Metric::throughput:            return "throughput";
+        }
+        return "";
+    }
+
+    /**
+     * Factor and SI prefix to display `units_per_second`, e.g.
+     * `{1e-9, "G"}` for 3e9.
+     */
+    static std::pair<double, char const*> si_scale(double units_per_second) noexcept
+    {
+        static constexpr std::pair<double, char const*> prefixes[] = {
+            {1e-12, "T"}, {1e-9, "G"}, {1e-6, "M"}, {1e-3, "k"}};
+        for (auto const& p : prefixes) {
+            if (units_per_second * p.first >= 1) return p;
+        }
+        return {1.0, ""};
+    }
+
+    /** Tells whether nanobench unit `unit` stands for bytes. */
+    static bool is_bytes(std::string const& unit) noexcept
+    {
+        return unit == "B" || unit == "byte" || unit == "bytes";
+    }
+
+    /** Plotly default colorway, for a result to have the same color in all subplots. */
+    static char const* plotly_color(std::size_t i) noexcept
+    {
+        static char const* const colors[] = {
+            "#1f77b4", "#ff7f0e", "#2ca02c", "#d62728", "#9467bd",
+            "#8c564b", "#e377c2", "#7f7f7f", "#bcbd22", "#17becf"};
+        return colors[i % std::size(colors)];
+    }
+
+    /** Actual implementation of `render_violins_to()`. */
+    void write_violins_to(ViolinPlot const& plot, std::string const& id)
+    {
+        start_plot(id, plot.title, nullptr);
+        std::vector<std::string> groups;
+        std::string              out = plot_prologue(id, m_encoding != PayloadEncoding::text)
+            + "        var data = [\n";
+        for (auto const& t : plot.traces) {
+            auto it = std::find(groups.begin(), groups.end(), t.group);
+            if (it == groups.end()) it = groups.insert(groups.end(), t.group);
+            std::string const color = plotly_color(std::size_t(it - groups.begin()));
+            out += "            {\n"
+                "                name: " + js_string(t.name + " [" + t.group + "]") + ",\n"
+                "                y: ";
+            append_samples(out, t.y);
+            out += ",\n"
+                "                x0: " + js_string(t.name) + ", offsetgroup: " + js_string(t.group)
+                + ", legendgroup: " + js_string(t.group) + ",\n"
+                "                marker: { color: '" + color + "' }, line: { color: '" + color + "' },\n"
+                "            },\n";
+        }
+        out += "        ];\n"
+            "\n"
+            "        data = data.map(a => Object.assign(a, { boxpoints: 'all', pointpos: 0, type: '" + m_plot_type + "', box: {visible: true}, meanline: {visible: true} }));\n"
+            "        var layout = { title: { text: " + js_string(plot.title) + " }, showlegend: " + m_show_legend
+            + ", violinmode: 'group', boxmode: 'group'"
+            + ", yaxis: { title: { text: " + js_string(plot.y_title) + " }" + m_range_mode + ", autorange: true } };\n"
+            "        Plotly.newPlot('" + id + "', data, layout, {responsive: true});\n"
+            + plot_epilogue(m_encoding != PayloadEncoding::text);
+        stream() << out;
+    }
+
+    /** Whether `m` can be drawn from the elapsed times of a baseline. */
+    static bool has_baseline_samples(Metric m) noexcept
+    {
+        return m == Metric::elapsed || m == Metric::throughput;
+    }
+
+    /**
+     * Reads the context variable `name` of `r` into `value`.
+     * @return whether `r` defines it.
+     */
+    static bool context_of(ankerl::nanobench::Result const& r, std::string const& name, std::string& value)
+    {
+        try {
+            value = r.context(name);
+            return true;
+        } catch (std::exception const&) {
+            // Variable not set for this result
+            return false;
+        }
+    }
+
+    /**
+     * Values of the `showcontext()` variables, as a subtitle for the
+     * plot of `b`. Distinct values of a variable among the results are
+     * listed once each.
+     */
+    std::string context_subtitle(ankerl::nanobench::Bench const& b) const
+    {
+        std::string out;
+        for (auto const& name : m_context) {
+            std::vector<std::string> values;
+            for (auto const& r : b.results()) {
+                std::string v;
+                if (context_of(r, name, v) && std::find(values.begin(), values.end(), v) == values.end()) {
+                    values.push_back(std::move(v));
+                }
+            }
+            if (values.empty()) continue;
+            out += out.empty() ? "<br><sup>" : "; ";
+            out += name + ": ";
+            for (std::size_t i = 0; i < values.size(); ++i) {
+                out += (i ? ", " : "") + values[i];
+            }
+        }
+        return out.empty() ? out : out + "</sup>";
+    }
+
+    /** Axis title for throughputs of `unit`, e.g. "GB/s" or "Gop/s". */
+    static std::string throughput_title(std::string const& unit, char const* prefix)
+    {
+        std::string const u = is_bytes(unit) ? "B" : !empty(unit) ? unit : "op";
+        return prefix + u + "/s";
+    }
+
+    /**
+     * Horizontal line drawn at the peak bandwidth -- if set -- on the
+     * throughput axis `yref`.
+     */
+    std::string peak_shape(std::string const& yref, double scale) const
+    {
+        if (m_peak_bandwidth <= 0) return "";
+        std::string out = "{ type: 'line', xref: 'paper', x0: 0, x1: 1, yref: '" + yref + "', y0: ";
+        append_number(out, m_peak_bandwidth * scale);
+        out += ", y1: ";
+        append_number(out, m_peak_bandwidth * scale);
+        out += ", line: { dash: 'dot', color: 'red' }, label: { text: " + js_string(m_peak_label)
+            + ", textposition: 'end' } }, ";
+        return out;
+    }
+
+    /**
+     * Median elapsed time per unit of `r`.
+     * nanobench measures the time per iteration, that processes `batch()`
+     * units.
+     */
+    static double median_per_unit(ankerl::nanobench::Result const& r)
+    {
+        return r.median(ankerl::nanobench::Result::Measure::elapsed) / r.config().mBatch;
+    }
+
+    /**
+     * Values of `m` for each measurement of `r`.
+     * nanobench measures them per iteration: time and counters are
+     * divided by `batch()` to obtain them per unit.
+     * @param[in] scale  Factor applied to `Metric::throughput`, see `si_scale()`.
+     * @return an empty vector if the required counters are missing.
+     */
+    static std::vector<double> metric_samples(
+            ankerl::nanobench::Result const& r, Metric m, double scale)
+    {
+        std::vector<double> res;
+        metric_samples(r, m, scale, res);
+        return res;
+    }
+
+    /** Same as above, but reusing the storage of `res`. */
+    static void metric_samples(
+            ankerl::nanobench::Result const& r, Metric m, double scale, std::vector<double>& res)
+    {
+        using Measure = ankerl::nanobench::Result::Measure;
+        res.clear();
+        auto const per_unit = [&r, &res](Measure measure) {
+            if (!r.has(measure)) return;
+            double const batch = r.config().mBatch;
+            for (std::size_t i = 0; i < r.size(); ++i) res.push_back(r.get(i, measure) / batch);
+        };
+        auto const ratio = [&r, &res](Measure num, Measure den) {
+            if (!r.has(num) || !r.has(den)) return;
+            for (std::size_t i = 0; i < r.size(); ++i) {
+                res.push_back(r.get(i, num) / r.get(i, den));
+            }
+        };
+        switch (m) {
+            case Metric::elapsed:               per_unit(Measure::elapsed); break;
+            case Metric::cycles_per_unit:       per_unit(Measure::cpucycles); break;
+            case Metric::instructions_per_unit: per_unit(Measure::instructions); break;
+            case Metric::ipc:                   ratio(Measure::instructions, Measure::cpucycles); break;
+            case Metric::branch_miss_rate:
+                ratio(Measure::branchmisses, Measure::branchinstructions);
+                break;
+            case Metric::throughput:
+                per_unit(Measure::elapsed);
+                for (auto& v : res) v = scale / v;
+                break;
+        }
+    }
+
+    /**
+     * Appends `values` as a JavaScript array, or as a call to `nbDecode()`
+     * with binary encodings.
+     */
+    void append_samples(std::string& out, std::vector<double> const& values) const
+    {
+        if (m_encoding == PayloadEncoding::text) {
+            out += '[';
+            for (std::size_t i = 0; i < values.size(); ++i) {
+                if (i) out += ", ";
+                append_number(out, values[i]);
+            }
+            out += ']';
+            return;
+        }
+        out += "await nbDecode('";
+        append_base64(out, encode_samples(values));
+        out += std::string("', ") + (m_encoding == PayloadEncoding::float32 ? "'f32'" : "'f64'")
+            + ", " + (m_compress ? "true" : "false") + ")";
+    }
+
+    /**
+     * Raw bytes of `values`, in the selected precision, and deflated if
+     * requested.
+     */
+    std::string encode_samples(std::vector<double> const& values) const
+    {
+        std::string raw;
+        if (m_encoding == PayloadEncoding::float32) {
+            raw.resize(values.size() * sizeof(float));
+            for (std::size_t i = 0; i < values.size(); ++i) {
+                float const v = float(values[i]);
+                std::memcpy(raw.data() + i * sizeof(float), &v, sizeof(float));
+            }
+        } else {
+            raw.resize(values.size() * sizeof(double));
+            std::memcpy(raw.data(), values.data(), raw.size());
+        }
+#if defined(NANOBENCH_HTML_GRAPH_USE_ZLIB)
+        if (m_compress) {
+            uLongf      size = compressBound(uLong(raw.size()));
+            std::string deflated(size, '\0');
+            if (compress2(reinterpret_cast<Bytef*>(deflated.data()), &size,
+                          reinterpret_cast<Bytef const*>(raw.data()), uLong(raw.size()),
+                          Z_BEST_COMPRESSION) != Z_OK) {
+                throw std::runtime_error("Cannot compress measurements");
+            }
+            deflated.resize(size);
+            return deflated;
+        }
+#endif
+        return raw;
+    }
+
+    /** Appends `bytes` encoded in base64. */
+    static void append_base64(std::string& out, std::string const& bytes)
+    {
+        static char const alphabet[]
+            = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        std::size_t const n = bytes.size();
+        out.reserve(out.size() + (n + 2) / 3 * 4);
+        std::size_t i = 0;
+        for (; i + 3 <= n; i += 3) {
+            std::uint32_t const v = std::uint32_t(std::uint8_t(bytes[i])) << 16
+                                  | std::uint32_t(std::uint8_t(bytes[i + 1])) << 8
+                                  | std::uint32_t(std::uint8_t(bytes[i + 2]));
+            out += alphabet[(v >> 18) & 63];
+            out += alphabet[(v >> 12) & 63];
+            out += alphabet[(v >> 6) & 63];
+            out += alphabet[v & 63];
+        }
+        if (i < n) {
+            std::uint32_t v = std::uint32_t(std::uint8_t(bytes[i])) << 16;
+            if (i + 1 < n) v |= std::uint32_t(std::uint8_t(bytes[i + 1])) << 8;
+            out += alphabet[(v >> 18) & 63];
+            out += alphabet[(v >> 12) & 63];
+            out += i + 1 < n ? alphabet[(v >> 6) & 63] : '=';
+            out += '=';
+        }
+    }
+
+    /**
+     * Opening of every plot: its `<div/>` and the start of its
+     * `<script>`.
+     * In lazy mode, the drawing code is wrapped into a function that
+     * `nbRegister()` calls once the `<div/>` scrolls into view. The
+     * `<div/>` then reserves the default plotly height so that all the
+     * plots aren't visible, and drawn, at once.
+     * @param[in] id        Name of the `<div/>`.
+     * @param[in] is_async  Whether the drawing code uses `await`.
+     */
+    std::string plot_prologue(std::string const& id, bool is_async) const
+    {
+        std::string const style = m_lazy ? " style='min-height: 450px;'" : "";
+        return "    <div id='" + id + "'" + style + ">\n"
             // Force no 100% space in-between graphs
             "      <div class='plot-container plotly' style='width: 100%;'></div>\n"
             "    </div>\n"
             "    <script>\n"
-            "        var data = [\n"
-            "            {{#result}}{\n"
-            "                name: '{{name}} (error: ' + (100*{{medianAbsolutePercentError(elapsed)}}).toFixed(2) + '%" + m_show_epochs + ")',\n"
-            "                y: [{{#measurement}}{{elapsed}}{{^-last}}, {{/last}}{{/measurement}}],\n"
-            "            },\n"
-            "            {{/result}}\n"
-            "        ];\n"
-            "        var title = '{{title}}';\n"
-            "\n"
-            "        data = data.map(a => Object.assign(a, { boxpoints: 'all', pointpos: 0, type: '" + type + "', box: {visible: true}, meanline: {visible: true} }));\n"
-            "        var layout = { title: { text: title }, showlegend: "+m_show_legend+", yaxis: { title: 'time per unit'" + m_range_mode + ", autorange: true } };\n"
-            "        Plotly.newPlot('" + id + "', data, layout, {responsive: true});\n"
-            "    </script>\n"
-            ;
-            // clang-format on
+            + (m_lazy ? "    nbRegister('" + id + "', async () => {\n"
+               : is_async ? std::string("    (async () => {\n")
+               : std::string());
+    }
+
+    /** Closing counterpart of `plot_prologue()`. */
+    std::string plot_epilogue(bool is_async) const
+    {
+        std::string const purge = m_purge_offscreen ? "true" : "false";
+        return (m_lazy ? "    }, { purge: " + purge + " });\n"
+                : is_async ? std::string("    })();\n")
+                : std::string())
+            + "    </script>\n";
+    }
+
+    /**
+     * Appends the shortest decimal representation of `v`, or `null` if
+     * it isn't finite: JavaScript has no literal for them.
+     */
+    static void append_number(std::string& out, double v)
+    {
+        if (!std::isfinite(v)) {
+            out += "null";
+            return;
+        }
+        char buffer[32];
+        auto const res = std::to_chars(buffer, buffer + sizeof(buffer), v);
+        out.append(buffer, res.ptr);
+    }
+
+    /**
+     * Returns `s` as a single-quoted JavaScript string literal, that can
+     * be embedded in a `<script>`.
+     */
+    static std::string js_string(std::string const& s)
+    {
+        std::string res;
+        append_js_string(res, s);
+        return res;
     }
 
-    std::string   m_plot_type;
-    std::string   m_show_legend = "false";
-    std::string   m_show_epochs = "";
-    std::string   m_range_mode  =  ", rangemode: 'tozero'";
-    std::string   m_filename;
-    std::ofstream m_file;
+    /**
+     * Appends `s` as a JavaScript string literal, see `js_string()`.
+     * Line terminators are escaped, U+2028 and U+2029 included, and so
+     * is `<`, which could close the `<script>`.
+     */
+    static void append_js_string(std::string& out, std::string_view s)
+    {
+        out.reserve(out.size() + s.size() + 2);
+        out += '\'';
+        for (std::size_t i = 0; i < s.size(); ++i) {
+            char const c = s[i];
+            switch (c) {
+                case '\\': out += "\\\\"; break;
+                case '\'': out += "\\'";  break;
+                case '\n': out += "\\n";  break;
+                case '\r': out += "\\r";  break;
+                case '<':  out += "\\x3c"; break;
+                default:
+                    // U+2028 and U+2029 are E2 80 A8 and E2 80 A9 in UTF-8
+                    if (s.substr(i, 3) == "\xE2\x80\xA8" || s.substr(i, 3) == "\xE2\x80\xA9") {
+                        out += s[i + 2] == '\xA8' ? "\\u2028" : "\\u2029";
+                        i += 2;
+                    } else {
+                        out += c;
+                    }
+            }
+        }
+        out += '\'';
+    }
+
+    std::string     m_plot_type;
+    std::string     m_show_legend     = "false";
+    bool            m_show_epochs     = false;
+    std::string     m_range_mode      =  ", rangemode: 'tozero'";
+    PayloadEncoding m_encoding        = PayloadEncoding::text;
+    bool            m_compress        = false;
+    bool            m_deferred        = false;
+    bool            m_lazy            = false;
+    bool            m_purge_offscreen = false;
+    bool            m_fragment        = false;
+    bool            m_timeseries      = false;
+    bool            m_raw_points      = false;
+    std::size_t     m_kde_points      = 0;
+    // The version number may need to change from time to time
+    std::string     m_plotly_url      = "https://cdn.plot.ly/plotly-3.0.1.min.js";
+    std::string     m_filename;
+    std::ofstream   m_file;
+
+    std::vector<Metric>          m_metrics        = {Metric::elapsed};
+    double                       m_peak_bandwidth = 0;
+    std::string                  m_peak_label;
+    std::vector<std::string>     m_context;
+    std::string                  m_group_by;
+    baseline_lookup              m_baseline;
+    topdown_lookup               m_topdown;
+    std::unique_ptr<sync_state>  m_sync           = std::make_unique<sync_state>();
+    std::unique_ptr<pages_state> m_pages;
+    std::string                  m_buffer;
 };
 
 #endif  // nanobench_html_graph_renderer
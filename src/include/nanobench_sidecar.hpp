@@ -0,0 +1,728 @@
+// Machine-readable JSON Lines and CSV outputs of nanobench results.
+// ======================================================================
+// Copyright (c) 2025 CS GROUP
+//
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// ======================================================================
+//
+// Authors:
+// - Luc Hermitte, initial author
+//
+// ======================================================================
+//
+// Defines:
+// - SidecarFormat: JSON Lines or CSV.
+// - BenchSidecar: streams every epoch of the results of each Bench it's
+//   given, with host, compiler, and any extra metadata.
+// - sidecar_result, SidecarReader: reads back JSON Lines sidecars, one
+//   result at a time.
+
+#ifndef nanobench_sidecar_hpp
+#define nanobench_sidecar_hpp
+
+#include "nanobench_html_graph_renderer.hpp"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <ctime>
+#include <exception>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#if __has_include(<unistd.h>)
+#  include <unistd.h>
+#endif
+
+/** Output formats of `BenchSidecar`. */
+enum class SidecarFormat
+{
+    json_lines, ///< One JSON object per line: metadata, then one per result
+    csv,        ///< One row per epoch of each result
+};
+
+/**
+ * Writes nanobench results in a machine-readable format, next to the
+ * HTML plots.
+ *
+ * Every epoch of every result is written: the number of iterations,
+ * the elapsed time and the hardware counters that have been collected
+ * -- per iteration, as `Result::get()` returns them: divide them by the
+ * batch to obtain them per unit --, with the title, name, unit, and
+ * batch of the result, and the `contexts()` variables.
+ *
+ * - In JSON Lines, the first line describes the host, compiler, and
+ *   nanobench version; then each line is a result:
+ *   ```json
+ *   {"type":"result","title":"mult/div float","name":"* L1","unit":"B","batch":6144,
+ *    "context":{"cache":"warm"},"epochs":{"elapsed":[...],"iterations":[...],...}}
+ *   ```
+ * - In CSV, each row is an epoch, and the host and compiler are
+ *   repeated on every row for the file to be loaded in one go.
+ *
+ * Results are written as soon as `write()` is called: memory stays
+ * bounded whatever the size of the suite.
+ *
+ * This class is not copiable, but moveable. `write()` can be called
+ * concurrently.
+ */
+class BenchSidecar
+{
+public:
+    using metadata_fields = std::vector<std::pair<std::string, std::string>>;
+
+    /**
+     * Only constructor.
+     * @throw None
+     * @post The output file isn't yet opened.
+     */
+    explicit BenchSidecar(SidecarFormat format)
+    : m_format(format)
+    {}
+
+    BenchSidecar(BenchSidecar const&)            = delete;
+    BenchSidecar(BenchSidecar&&)                 = default;
+    BenchSidecar& operator=(BenchSidecar const&) = delete;
+    BenchSidecar& operator=(BenchSidecar&&)      = default;
+
+#if defined(__cpp_explicit_this_parameter)
+    /**
+     * Tells which `Bench::context()` variables to write with each
+     * result.
+     *
+     * Setter meant to be used from _builder pattern_.
+     * It works on lvalue and rvalue instances of `BenchSidecar`.
+     * @param[in] names  Context variables; in CSV, one column each.
+     * @return this
+     * @pre The file hasn't been opened yet.
+     */
+    template <typename Self>
+    Self&& contexts(this Self&& self, std::vector<std::string> names)
+    {
+        self.m_contexts = std::move(names);
+        return std::forward<Self>(self);
+    }
+#else
+    BenchSidecar&& contexts(std::vector<std::string> names) &&
+    {
+        m_contexts = std::move(names);
+        return std::move(*this);
+    }
+    BenchSidecar& contexts(std::vector<std::string> names) &
+    {
+        m_contexts = std::move(names);
+        return *this;
+    }
+#endif
+
+#if defined(__cpp_explicit_this_parameter)
+    /**
+     * Adds fields to the JSON metadata line, e.g. the fingerprint of
+     * `BenchEnvironment`.
+     *
+     * Setter meant to be used from _builder pattern_.
+     * It works on lvalue and rvalue instances of `BenchSidecar`.
+     * @param[in] fields  (key, value) pairs; the keys of the builtin
+     *                    metadata -- host, cpu, compiler... -- are
+     *                    ignored.
+     * @return this
+     * @pre The file hasn't been opened yet.
+     */
+    template <typename Self>
+    Self&& metadata(this Self&& self, metadata_fields fields)
+    {
+        self.m_metadata = std::move(fields);
+        return std::forward<Self>(self);
+    }
+#else
+    BenchSidecar&& metadata(metadata_fields fields) &&
+    {
+        m_metadata = std::move(fields);
+        return std::move(*this);
+    }
+    BenchSidecar& metadata(metadata_fields fields) &
+    {
+        m_metadata = std::move(fields);
+        return *this;
+    }
+#endif
+
+    /**
+     * Opens the output file, and writes the metadata line or the CSV
+     * header.
+     * @throw std::runtime_error if `filename` cannot be opened.
+     */
+    void open(std::string filename)
+    {
+        open_fragment(std::move(filename));
+        std::lock_guard lock(*m_mutex);
+        if (m_format == SidecarFormat::json_lines) {
+            m_file << metadata_line();
+        } else {
+            m_file << "host,compiler,title,name,unit,batch";
+            for (auto const& c : m_contexts) m_file << ',' << csv_field(c);
+            m_file << ",epoch";
+            for (auto const& m : measures) m_file << ',' << m.name;
+            m_file << '\n';
+        }
+    }
+
+    /**
+     * Opens an output file without metadata nor header, to be appended
+     * to the main file with `append_fragment()`.
+     * @throw std::runtime_error if `filename` cannot be opened.
+     */
+    void open_fragment(std::string filename)
+    {
+        m_filename = std::move(filename);
+        m_file.open(m_filename);
+        if (!m_file) {
+            throw std::runtime_error("Cannot write results to " + m_filename);
+        }
+    }
+
+    /** Closes the file. See `HtmlGraphRenderer::detach()`. */
+    void detach() noexcept
+    {
+        m_file.close();
+    }
+
+    /**
+     * Appends the content of a fragment file to the output file.
+     * @throw std::runtime_error if `filename` cannot be read.
+     */
+    void append_fragment(std::string const& filename)
+    {
+        std::ifstream fragment(filename);
+        if (!fragment) {
+            throw std::runtime_error("Cannot read results fragment " + filename);
+        }
+        std::lock_guard lock(*m_mutex);
+        if (fragment.peek() != std::ifstream::traits_type::eof()) {
+            m_file << fragment.rdbuf();
+        }
+    }
+
+    /** Tells whether an opened file has been associated to the instance. */
+    [[nodiscard]]
+    explicit operator bool() const
+    {
+        return m_file.is_open() && bool(m_file);
+    }
+
+    /**
+     * Writes all the results of `b`.
+     * @throw std::bad_alloc if memory is exhausted.
+     * @note This function can be called concurrently.
+     */
+    void write(ankerl::nanobench::Bench const& b)
+    {
+        for (auto const& r : b.results()) {
+            std::string const out = m_format == SidecarFormat::json_lines ? json_result(b, r) : csv_rows(b, r);
+            std::lock_guard   lock(*m_mutex);
+            m_file << out;
+        }
+    }
+
+    /** Flushes the file. */
+    void flush()
+    {
+        std::lock_guard lock(*m_mutex);
+        m_file.flush();
+    }
+
+private:
+    using Measure = ankerl::nanobench::Result::Measure;
+
+    struct measure
+    {
+        Measure     id;
+        char const* name;
+    };
+
+    static constexpr std::array<measure, 8> measures = {{
+        {Measure::elapsed, "elapsed"},
+        {Measure::iterations, "iterations"},
+        {Measure::pagefaults, "pagefaults"},
+        {Measure::cpucycles, "cpucycles"},
+        {Measure::contextswitches, "contextswitches"},
+        {Measure::instructions, "instructions"},
+        {Measure::branchinstructions, "branchinstructions"},
+        {Measure::branchmisses, "branchmisses"},
+    }};
+
+    static std::string const& host_name()
+    {
+        static std::string const host = [] {
+#if __has_include(<unistd.h>)
+            char name[256] = {};
+            if (::gethostname(name, sizeof(name) - 1) == 0 && name[0]) return std::string(name);
+#endif
+            return std::string("unknown");
+        }();
+        return host;
+    }
+
+    static std::string const& compiler()
+    {
+#if defined(__clang__)
+        static std::string const name = "clang " __clang_version__;
+#elif defined(__GNUC__)
+        static std::string const name = "gcc " __VERSION__;
+#elif defined(_MSC_FULL_VER)
+        static std::string const name = "msvc " + std::to_string(_MSC_FULL_VER);
+#else
+        static std::string const name = "unknown";
+#endif
+        return name;
+    }
+
+    static std::string cpu_model()
+    {
+        std::ifstream cpuinfo("/proc/cpuinfo");
+        std::string   line;
+        while (std::getline(cpuinfo, line)) {
+            if (line.rfind("model name", 0) == 0) {
+                auto const colon = line.find(':');
+                if (colon != std::string::npos) return line.substr(line.find_first_not_of(' ', colon + 1));
+            }
+        }
+        return "unknown";
+    }
+
+    std::string metadata_line() const
+    {
+        char              date[32] = "";
+        std::time_t const now      = std::time(nullptr);
+        if (std::tm const* utc = std::gmtime(&now)) {
+            std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", utc);
+        }
+        std::string out = "{\"type\":\"metadata\",\"host\":" + json_string(host_name())
+            + ",\"cpu\":" + json_string(cpu_model()) + ",\"compiler\":" + json_string(compiler())
+            + ",\"cplusplus\":" + std::to_string(__cplusplus);
+#if defined(ANKERL_NANOBENCH_VERSION_MAJOR)
+        out += ",\"nanobench\":\"" + std::to_string(ANKERL_NANOBENCH_VERSION_MAJOR) + "."
+            + std::to_string(ANKERL_NANOBENCH_VERSION_MINOR) + "."
+            + std::to_string(ANKERL_NANOBENCH_VERSION_PATCH) + "\"";
+#endif
+        out += ",\"date\":\"" + std::string(date) + "\"";
+        for (auto const& [key, value] : m_metadata) {
+            static constexpr std::string_view builtin[] = {"type", "host", "cpu", "compiler", "cplusplus", "nanobench", "date"};
+            if (std::find(std::begin(builtin), std::end(builtin), key) != std::end(builtin)) continue;
+            out += "," + json_string(key) + ":" + json_string(value);
+        }
+        return out + "}\n";
+    }
+
+    std::string json_result(ankerl::nanobench::Bench const& b, ankerl::nanobench::Result const& r) const
+    {
+        auto const& c   = r.config();
+        std::string out = "{\"type\":\"result\",\"title\":" + json_string(b.title())
+            + ",\"name\":" + json_string(c.mBenchmarkName) + ",\"unit\":" + json_string(c.mUnit)
+            + ",\"batch\":";
+        append_number(out, c.mBatch);
+        out += ",\"context\":{";
+        bool first = true;
+        for (auto const& name : m_contexts) {
+            std::string value;
+            if (!context_of(r, name, value)) continue;
+            out += (first ? "" : ",") + json_string(name) + ":" + json_string(value);
+            first = false;
+        }
+        out += "},\"epochs\":{";
+        first = true;
+        for (auto const& m : measures) {
+            if (!r.has(m.id)) continue;
+            out += (first ? "\"" : ",\"") + std::string(m.name) + "\":[";
+            for (std::size_t i = 0; i < r.size(); ++i) {
+                if (i) out += ',';
+                append_number(out, r.get(i, m.id));
+            }
+            out += ']';
+            first = false;
+        }
+        return out + "}}\n";
+    }
+
+    std::string csv_rows(ankerl::nanobench::Bench const& b, ankerl::nanobench::Result const& r) const
+    {
+        auto const& c      = r.config();
+        std::string prefix = csv_field(host_name()) + "," + csv_field(compiler()) + ","
+            + csv_field(b.title()) + "," + csv_field(c.mBenchmarkName) + "," + csv_field(c.mUnit) + ",";
+        append_number(prefix, c.mBatch);
+        for (auto const& name : m_contexts) {
+            std::string value;
+            context_of(r, name, value);
+            prefix += "," + csv_field(value);
+        }
+
+        std::string out;
+        for (std::size_t i = 0; i < r.size(); ++i) {
+            out += prefix + "," + std::to_string(i);
+            for (auto const& m : measures) {
+                out += ',';
+                if (r.has(m.id)) append_number(out, r.get(i, m.id));
+            }
+            out += '\n';
+        }
+        return out;
+    }
+
+    static bool context_of(ankerl::nanobench::Result const& r, std::string const& name, std::string& value)
+    {
+        try {
+            value = r.context(name);
+            return true;
+        } catch (std::exception const&) {
+            // Variable not set for this result
+            return false;
+        }
+    }
+
+    /// Shortest representation that reads back the same; null if not finite.
+    static void append_number(std::string& out, double value)
+    {
+        if (!std::isfinite(value)) {
+            out += "null";
+            return;
+        }
+        char buffer[32];
+        auto const [end, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        out.append(buffer, ec == std::errc() ? end : buffer);
+    }
+
+    static std::string json_string(std::string const& s)
+    {
+        std::string out = "\"";
+        for (char const ch : s) {
+            switch (ch) {
+                case '"':  out += "\\\""; break;
+                case '\\': out += "\\\\"; break;
+                case '\n': out += "\\n"; break;
+                case '\r': out += "\\r"; break;
+                case '\t': out += "\\t"; break;
+                default:
+                    if (static_cast<unsigned char>(ch) < 0x20) {
+                        char buffer[8];
+                        std::snprintf(buffer, sizeof(buffer), "\\u%04x", unsigned(ch));
+                        out += buffer;
+                    } else {
+                        out += ch;
+                    }
+            }
+        }
+        return out + "\"";
+    }
+
+    /// RFC 4180 quoting, only when needed.
+    static std::string csv_field(std::string const& s)
+    {
+        if (s.find_first_of(",\"\r\n") == std::string::npos) return s;
+        std::string out = "\"";
+        for (char const ch : s) {
+            if (ch == '"') out += '"';
+            out += ch;
+        }
+        return out + "\"";
+    }
+
+    SidecarFormat               m_format;
+    std::vector<std::string>    m_contexts;
+    metadata_fields             m_metadata;
+    std::string                 m_filename;
+    std::ofstream               m_file;
+    std::unique_ptr<std::mutex> m_mutex = std::make_unique<std::mutex>();
+};
+
+/** A result read from a JSON Lines sidecar. */
+struct sidecar_result
+{
+    std::string                                title;
+    std::string                                name;
+    std::string                                unit;
+    double                                     batch = 1;
+    std::map<std::string, std::string>         context;
+    std::map<std::string, std::vector<double>> epochs; ///< Per measure: "elapsed"...
+};
+
+/**
+ * Reads JSON Lines files written by `BenchSidecar`, one line at a time:
+ * memory stays bounded whatever the size of the file.
+ *
+ * ```c++
+ * SidecarReader  in("results.jsonl");
+ * sidecar_result r;
+ * while (in.next(r)) { ... r.epochs["elapsed"] ... }
+ * ```
+ *
+ * The parser accepts any JSON value, but only the layout written by
+ * `BenchSidecar` is interpreted; unknown members are ignored.
+ */
+class SidecarReader
+{
+public:
+    /**
+     * Opens `filename`.
+     * @throw std::runtime_error if `filename` cannot be opened.
+     */
+    explicit SidecarReader(std::string const& filename)
+    : m_filename(filename)
+    , m_file(filename)
+    {
+        if (!m_file) {
+            throw std::runtime_error("Cannot read results from " + filename);
+        }
+    }
+
+    /**
+     * Reads the next result. Metadata lines are recorded on the way.
+     * @param[out] r  Result read, if any.
+     * @return false at the end of the file.
+     * @throw std::runtime_error on malformed lines.
+     */
+    bool next(sidecar_result& r)
+    {
+        std::string line;
+        while (std::getline(m_file, line)) {
+            ++m_line;
+            if (line.find_first_not_of(" \t\r") == std::string::npos) continue;
+            json_value v;
+            try {
+                std::string_view in = line;
+                v                   = parse_value(in);
+                skip_spaces(in);
+                if (!in.empty()) throw std::runtime_error("trailing characters");
+                if (v.kind != json_value::kind_t::object) throw std::runtime_error("object expected");
+            } catch (std::runtime_error const& e) {
+                throw std::runtime_error(
+                        m_filename + ":" + std::to_string(m_line) + ": invalid JSON, " + e.what());
+            }
+            json_value const* type = v.member("type");
+            if (type && type->string == "metadata") {
+                for (std::size_t i = 0; i < v.keys.size(); ++i) {
+                    if (v.values[i].kind == json_value::kind_t::string) m_metadata[v.keys[i]] = v.values[i].string;
+                }
+                continue;
+            }
+            r = to_result(v);
+            return true;
+        }
+        return false;
+    }
+
+    /** Metadata read so far: "host", "compiler"... */
+    [[nodiscard]]
+    std::map<std::string, std::string> const& metadata() const noexcept { return m_metadata; }
+
+private:
+    struct json_value
+    {
+        enum class kind_t { null, boolean, number, string, array, object };
+
+        kind_t                   kind = kind_t::null;
+        double                   num  = 0;
+        std::string              string;
+        std::vector<json_value>  values; ///< Of arrays and objects
+        std::vector<std::string> keys;   ///< Of objects
+
+        json_value const* member(std::string_view key) const noexcept
+        {
+            for (std::size_t i = 0; i < keys.size(); ++i) {
+                if (keys[i] == key) return &values[i];
+            }
+            return nullptr;
+        }
+    };
+
+    static void skip_spaces(std::string_view& in) noexcept
+    {
+        while (!in.empty() && (in.front() == ' ' || in.front() == '\t' || in.front() == '\r')) {
+            in.remove_prefix(1);
+        }
+    }
+
+    static void expect(std::string_view& in, char c)
+    {
+        skip_spaces(in);
+        if (in.empty() || in.front() != c) throw std::runtime_error(std::string("'") + c + "' expected");
+        in.remove_prefix(1);
+    }
+
+    static std::string parse_string(std::string_view& in)
+    {
+        expect(in, '"');
+        std::string out;
+        while (!in.empty() && in.front() != '"') {
+            char c = in.front();
+            in.remove_prefix(1);
+            if (c == '\\') {
+                if (in.empty()) break;
+                c = in.front();
+                in.remove_prefix(1);
+                switch (c) {
+                    case 'n': c = '\n'; break;
+                    case 'r': c = '\r'; break;
+                    case 't': c = '\t'; break;
+                    case 'b': c = '\b'; break;
+                    case 'f': c = '\f'; break;
+                    case 'u': {
+                        unsigned code = 0;
+                        if (in.size() < 4 || std::from_chars(in.data(), in.data() + 4, code, 16).ptr != in.data() + 4) {
+                            throw std::runtime_error("invalid \\u escape");
+                        }
+                        in.remove_prefix(4);
+                        append_utf8(out, code);
+                        continue;
+                    }
+                    default: break; // '"', '\\', '/'
+                }
+            }
+            out += c;
+        }
+        expect(in, '"');
+        return out;
+    }
+
+    /// Surrogate pairs aren't combined: BenchSidecar only escapes controls.
+    static void append_utf8(std::string& out, unsigned code)
+    {
+        if (code < 0x80) {
+            out += char(code);
+        } else if (code < 0x800) {
+            out += char(0xC0 | (code >> 6));
+            out += char(0x80 | (code & 0x3F));
+        } else {
+            out += char(0xE0 | (code >> 12));
+            out += char(0x80 | ((code >> 6) & 0x3F));
+            out += char(0x80 | (code & 0x3F));
+        }
+    }
+
+    static json_value parse_value(std::string_view& in)
+    {
+        skip_spaces(in);
+        if (in.empty()) throw std::runtime_error("value expected");
+        json_value v;
+        switch (in.front()) {
+            case '{':
+                v.kind = json_value::kind_t::object;
+                in.remove_prefix(1);
+                skip_spaces(in);
+                if (!in.empty() && in.front() == '}') {
+                    in.remove_prefix(1);
+                    return v;
+                }
+                for (;;) {
+                    v.keys.push_back(parse_string(in));
+                    expect(in, ':');
+                    v.values.push_back(parse_value(in));
+                    skip_spaces(in);
+                    if (!in.empty() && in.front() == ',') {
+                        in.remove_prefix(1);
+                        continue;
+                    }
+                    expect(in, '}');
+                    return v;
+                }
+            case '[':
+                v.kind = json_value::kind_t::array;
+                in.remove_prefix(1);
+                skip_spaces(in);
+                if (!in.empty() && in.front() == ']') {
+                    in.remove_prefix(1);
+                    return v;
+                }
+                for (;;) {
+                    v.values.push_back(parse_value(in));
+                    skip_spaces(in);
+                    if (!in.empty() && in.front() == ',') {
+                        in.remove_prefix(1);
+                        continue;
+                    }
+                    expect(in, ']');
+                    return v;
+                }
+            case '"':
+                v.kind   = json_value::kind_t::string;
+                v.string = parse_string(in);
+                return v;
+            default:
+                for (auto const& [word, kind, value] : {
+                             std::tuple{std::string_view("null"), json_value::kind_t::null, 0.0},
+                             std::tuple{std::string_view("true"), json_value::kind_t::boolean, 1.0},
+                             std::tuple{std::string_view("false"), json_value::kind_t::boolean, 0.0}}) {
+                    if (in.substr(0, word.size()) == word) {
+                        in.remove_prefix(word.size());
+                        v.kind = kind;
+                        v.num  = value;
+                        return v;
+                    }
+                }
+                auto const [end, ec] = std::from_chars(in.data(), in.data() + in.size(), v.num);
+                if (ec != std::errc()) throw std::runtime_error("invalid number");
+                in.remove_prefix(std::size_t(end - in.data()));
+                v.kind = json_value::kind_t::number;
+                return v;
+        }
+    }
+
+    static sidecar_result to_result(json_value const& v)
+    {
+        sidecar_result r;
+        if (auto const* m = v.member("title")) r.title = m->string;
+        if (auto const* m = v.member("name")) r.name = m->string;
+        if (auto const* m = v.member("unit")) r.unit = m->string;
+        if (auto const* m = v.member("batch")) r.batch = m->num;
+        if (auto const* m = v.member("context")) {
+            for (std::size_t i = 0; i < m->keys.size(); ++i) r.context[m->keys[i]] = m->values[i].string;
+        }
+        if (auto const* m = v.member("epochs")) {
+            for (std::size_t i = 0; i < m->keys.size(); ++i) {
+                auto& samples = r.epochs[m->keys[i]];
+                for (auto const& x : m->values[i].values) {
+                    samples.push_back(x.kind == json_value::kind_t::number ? x.num
+                                                                  : std::numeric_limits<double>::quiet_NaN());
+                }
+            }
+        }
+        return r;
+    }
+
+    std::string                        m_filename;
+    std::ifstream                      m_file;
+    std::size_t                        m_line = 0;
+    std::map<std::string, std::string> m_metadata;
+};
+
+#endif // nanobench_sidecar_hpp
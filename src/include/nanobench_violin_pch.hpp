@@ -0,0 +1,54 @@
+// Header to precompile for the test cases of a benchmark suite.
+// ======================================================================
+// Copyright (c) 2025 CS GROUP
+//
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// ======================================================================
+//
+// Authors:
+// - Luc Hermitte, initial author
+//
+// ======================================================================
+//
+// Gathers the headers that every test case of a suite includes, and that
+// take most of its compilation time. Meant to be precompiled with the
+// same flags as the test cases, including
+// -DNANOBENCH_VIOLIN_SEPARATE_IMPLEMENTATION, see nanobench_impl.cpp:
+//
+//     g++ $(CXXFLAGS) -x c++-header nanobench_violin_pch.hpp -o nanobench_violin_pch.hpp.gch
+//
+// and included first by each test case file. It cannot be used by the
+// file that includes nanobench_html_graph_doctest_main.hpp, which
+// compiles the implementation of doctest.
+
+#ifndef nanobench_violin_pch_hpp
+#define nanobench_violin_pch_hpp
+
+#include "dataset_cache.hpp"
+#include "nanobench_html_graph_doctest.hpp"
+#include "test_vector.hpp"
+#include <span>
+#include <string>
+#include <vector>
+
+#endif // nanobench_violin_pch_hpp
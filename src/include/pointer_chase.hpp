@@ -0,0 +1,225 @@
+// Memory latency benchmarks by pointer chasing.
+// ======================================================================
+// Copyright (c) 2025 CS GROUP
+//
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// ======================================================================
+//
+// Authors:
+// - Luc Hermitte, initial author
+//
+// ======================================================================
+//
+// Defines:
+// - PointerChain: a random cyclic chain of pointers, one per cache line.
+// - LatencySweep: load-to-use latency over working-set sizes that cross
+//   every cache level, and the resulting LinePlot with the plateaus of
+//   each level.
+
+#ifndef pointer_chase_hpp
+#define pointer_chase_hpp
+
+#include "rng.hpp"
+#include "test_vector.hpp"
+#include "working_set_sweep.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * Random cyclic chain of pointers, one per cache line of a buffer.
+ *
+ * The order of the lines is a random cyclic permutation generated with
+ * Sattolo's algorithm: following the pointers from any line visits all
+ * the lines before coming back. Each load depends on the previous one,
+ * and the hardware prefetchers can't guess the next line. The time per
+ * step is then the load-to-use latency of the memory level where the
+ * buffer fits.
+ */
+class PointerChain
+{
+public:
+    /**
+     * Builds the chain.
+     * @param[in] bytes      Size of the buffer.
+     * @param[in] line_size  Distance between two pointers, i.e. the cache
+     *                       line size.
+     * @param[in] seed       Seed of the permutation.
+     * @throw std::bad_alloc if memory is exhausted.
+     * @pre `line_size` is a multiple of `sizeof(void*)`.
+     */
+    PointerChain(std::size_t bytes, std::size_t line_size, std::uint64_t seed = 1)
+    : m_stride(std::max<std::size_t>(1, line_size / sizeof(void*)))
+    , m_nodes(std::max<std::size_t>(2, bytes / (m_stride * sizeof(void*))))
+    , m_buffer(m_nodes * m_stride)
+    {
+        // Sattolo: like Fisher-Yates, but j < i, for a single cycle
+        std::vector<std::size_t> next(m_nodes);
+        std::iota(next.begin(), next.end(), std::size_t(0));
+        RNG<std::uint64_t> const rng(rng_seed{seed}, m_nodes);
+        for (std::size_t i = m_nodes - 1; i > 0; --i) {
+            auto const j = std::size_t((static_cast<unsigned __int128>(rng[i]) * i) >> 64);
+            std::swap(next[i], next[j]);
+        }
+        for (std::size_t i = 0; i < m_nodes; ++i) {
+            m_buffer[i * m_stride] = &m_buffer[next[i] * m_stride];
+        }
+    }
+
+    /** First element of the chain. */
+    [[nodiscard]] void* const* start() const noexcept { return m_buffer.data(); }
+
+    /** Number of cache lines in the chain. */
+    [[nodiscard]] std::size_t size() const noexcept { return m_nodes; }
+
+    /**
+     * Follows `steps` pointers from `p`.
+     * @return Where the chase stopped, to continue from there.
+     */
+    static void* const* chase(void* const* p, std::size_t steps) noexcept
+    {
+        for (std::size_t s = 0; s < steps; ++s) {
+            p = static_cast<void* const*>(*p);
+        }
+        return p;
+    }
+
+private:
+    std::size_t        m_stride;
+    std::size_t        m_nodes;
+    test_vector<void*> m_buffer;
+};
+
+/**
+ * Load-to-use latency across the cache hierarchy.
+ *
+ * A `PointerChain` is chased for each working-set size of a
+ * `WorkingSetSweep`. The plot shows nanoseconds per load with the cache
+ * boundaries marked, and a horizontal line at the latency plateau of
+ * each level: the median latency of the sizes well within that level.
+ */
+class LatencySweep
+{
+public:
+    static constexpr std::size_t loads_per_call = std::size_t(1) << 14;
+
+    /**
+     * Constructs a sweep with the default sizes for `topology`.
+     * @throw std::bad_alloc if memory is exhausted.
+     */
+    explicit LatencySweep(
+            CacheTopology topology = CacheTopology::detect(), unsigned points_per_octave = 2)
+    : m_sweep(std::move(topology), points_per_octave)
+    {}
+
+    /**
+     * Measures the latency for every working-set size.
+     * @param[in,out] bench   Benchmark object where results are appended.
+     *                        Its `batch()` and `unit()` are set.
+     * @param[in]     series  Name of the series.
+     * @return *this
+     * @throw std::bad_alloc if memory is exhausted.
+     */
+    LatencySweep& run(ankerl::nanobench::Bench& bench, std::string const& series = "load")
+    {
+        std::size_t const line = m_sweep.topology().line_size();
+        bench.unit("load");
+        m_sweep.run(bench, series, [line](ankerl::nanobench::Bench& b, std::size_t bytes) {
+            b.batch(loads_per_call);
+            auto chain = std::make_shared<PointerChain const>(bytes, line);
+            return [chain, p = chain->start()]() mutable {
+                p = PointerChain::chase(p, loads_per_call);
+                ankerl::nanobench::doNotOptimizeAway(p);
+            };
+        });
+        return *this;
+    }
+
+    [[nodiscard]] WorkingSetSweep const& sweep() const noexcept { return m_sweep; }
+
+    /**
+     * Plot of the latencies measured so far, in nanoseconds per load.
+     * @param[in] bench  Benchmark object passed to `run()`.
+     * @throw std::bad_alloc if memory is exhausted.
+     */
+    [[nodiscard]]
+    LinePlot plot(ankerl::nanobench::Bench const& bench) const
+    {
+        using Measure = ankerl::nanobench::Result::Measure;
+        LinePlot res = m_sweep.plot();
+        res.y_title    = "ns per load";
+        res.y_scale    = 1e9;
+        res.throughput = false;
+        if (res.series.empty()) return res;
+
+        auto const& s = res.series.front();
+        // Median latency of the sizes in [first, last]
+        auto const plateau = [&](double first, double last) -> double {
+            std::vector<double> latencies;
+            for (std::size_t i = 0; i < s.x.size(); ++i) {
+                if (first <= s.x[i] && s.x[i] <= last) {
+                    // nanobench measures the time of a call, that chases `batch()` loads
+                    auto const& r = bench.results().at(s.results[i]);
+                    latencies.push_back(r.median(Measure::elapsed) / r.config().mBatch * 1e9);
+                }
+            }
+            if (latencies.empty()) return 0;
+            std::nth_element(latencies.begin(), latencies.begin() + latencies.size() / 2, latencies.end());
+            return latencies[latencies.size() / 2];
+        };
+        auto const add_plateau = [&](std::string const& level, double latency) {
+            if (latency <= 0) return;
+            res.y_markers.push_back({latency, level + " " + format_ns(latency)});
+        };
+        // Sizes near the boundaries are skipped: other data, TLB misses,
+        // and replacement policies blur the transitions
+        double lower = 0;
+        for (auto const& l : m_sweep.topology().levels()) {
+            double const upper = double(l.size);
+            double const latency = plateau(2 * lower, upper / 2);
+            add_plateau("L" + std::to_string(l.number), latency > 0 ? latency : plateau(lower, upper));
+            lower = upper;
+        }
+        add_plateau("DRAM", plateau(2 * lower, s.x.back()));
+        return res;
+    }
+
+private:
+    static std::string format_ns(double ns)
+    {
+        std::string res = std::to_string(std::round(ns * 10) / 10);
+        res.erase(res.find('.') + 2);
+        return res + " ns";
+    }
+
+    WorkingSetSweep m_sweep;
+};
+
+#endif // pointer_chase_hpp
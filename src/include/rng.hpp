@@ -38,8 +38,22 @@
 #define random_ranges_hpp
 
 #include <random>
+#include <algorithm>
+#include <compare>
+#include <array>
+#include <bit>
 #include <cassert>
+#include <cmath>
+#include <concepts>
+#include <cstdint>
+#include <iterator>
 #include <limits>
+#include <ranges>
+#include <span>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 template <typename T, bool is_integral>
 struct uniform_distribution {};
@@ -57,55 +71,732 @@ struct uniform_distribution<T, false> {
 template <typename T>
 using uniform_distribution_t = typename uniform_distribution<T, std::is_integral<T>::value>::type;
 
+/**
+ * Branchless mapping of 64 random bits into `[min, max]`.
+ *
+ * Unlike `uniform_distribution_t<T>`, there is no rejection loop: the
+ * mapping is meant to be applied to a whole block of random numbers at
+ * once, and to be vectorized by the compiler. The price is a negligible
+ * bias for ranges that aren't powers of 2.
+ */
+template <typename T, bool is_integral>
+struct uniform_mapping {};
 
 template <typename T>
-class RNG
+struct uniform_mapping<T, true> {
+    using value_type    = T;
+    using unsigned_type = std::make_unsigned_t<T>;
+    static constexpr unsigned random_bits = sizeof(T) <= 4 ? 32 : 64;
+
+    uniform_mapping() = default;
+    constexpr uniform_mapping(T min_, T max_)
+    : m_min(static_cast<unsigned_type>(min_))
+    // The difference of 8- and 16-bit types is promoted to int: it's
+    // brought back to unsigned_type before being widened
+    , m_range(std::uint64_t(unsigned_type(unsigned_type(max_) - unsigned_type(min_))) + 1)
+    {
+        assert(min_ <= max_);
+    }
+
+    constexpr T operator()(std::uint64_t bits) const noexcept
+    {
+        if constexpr (sizeof(T) <= 4) {
+            // Lemire's multiply-shift: [0, 2^32) * range / 2^32 fits in 64 bits
+            auto const offset = ((bits >> 32) * m_range) >> 32;
+            return static_cast<T>(static_cast<unsigned_type>(m_min + offset));
+        } else {
+            // m_range == 0 means the full 64-bit range has been requested
+            auto const offset = m_range
+                ? std::uint64_t((static_cast<unsigned __int128>(bits) * m_range) >> 64)
+                : bits;
+            return static_cast<T>(static_cast<unsigned_type>(m_min + offset));
+        }
+    }
+
+    friend auto operator<=>(uniform_mapping const&, uniform_mapping const&) = default;
+
+private:
+    unsigned_type m_min   = 0;
+    std::uint64_t m_range = 0;
+};
+
+template <typename T>
+struct uniform_mapping<T, false> {
+    using value_type = T;
+    static constexpr unsigned random_bits = std::numeric_limits<T>::digits <= 32 ? 32 : 64;
+
+    uniform_mapping() = default;
+    uniform_mapping(T min_, T max_)
+    : m_min(min_)
+    , m_range(max_ - min_)
+    {
+        assert(min_ <= max_);
+    }
+
+    T operator()(std::uint64_t bits) const noexcept
+    {
+        // Keep as many high bits as the mantissa can hold => u in [0, 1)
+        constexpr int digits = std::numeric_limits<T>::digits;
+        T const u = T(bits >> (64 - digits)) * (T(1) / T(std::uint64_t(1) << digits));
+        // Explicit fma => same rounding whether the compiler contracts or not
+        return std::fma(u, m_range, m_min);
+    }
+
+    friend auto operator<=>(uniform_mapping const&, uniform_mapping const&) = default;
+
+private:
+    T m_min   = 0;
+    T m_range = 0;
+};
+
+template <typename T>
+using uniform_mapping_t = uniform_mapping<T, std::is_integral<T>::value>;
+
+// Bounds of small signed ranges, that do and do not span zero
+static_assert(uniform_mapping_t<std::int8_t>(-128, 127)(0) == -128);
+static_assert(uniform_mapping_t<std::int8_t>(-128, 127)(~std::uint64_t(0)) == 127);
+static_assert(uniform_mapping_t<std::int8_t>(-128, 127)(std::uint64_t(1) << 63) == 0);
+static_assert(uniform_mapping_t<std::int8_t>(10, 20)(0) == 10);
+static_assert(uniform_mapping_t<std::int8_t>(10, 20)(~std::uint64_t(0)) == 20);
+static_assert(uniform_mapping_t<std::int16_t>(-5, 5)(0) == -5);
+static_assert(uniform_mapping_t<std::int16_t>(-5, 5)(~std::uint64_t(0)) == 5);
+static_assert(uniform_mapping_t<std::int16_t>(-5, 5)(std::uint64_t(1) << 63) == 0);
+static_assert(uniform_mapping_t<std::int16_t>(-300, -100)(0) == -300);
+static_assert(uniform_mapping_t<std::int16_t>(-300, -100)(~std::uint64_t(0)) == -100);
+static_assert(uniform_mapping_t<std::int64_t>(-5, 5)(~std::uint64_t(0)) == 5);
+
+/**
+ * Mapping of random bits into the numbers of a `RNG`.
+ *
+ * A mapping declares:
+ * - `value_type`, the type of the numbers,
+ * - `random_bits`, 32 or 64: how many left-aligned random bits each
+ *   number needs -- with 32, the lower half of `bits` is 0, and twice
+ *   as many numbers are produced per Philox counter,
+ * - `operator()(std::uint64_t bits)`, or `operator()(std::uint64_t bits,
+ *   std::size_t index)` for the shapes that depend on the position of
+ *   the number in the sequence.
+ *
+ * The call operator is applied to whole blocks of numbers: it should be
+ * branchless to be vectorized.
+ */
+template <typename M>
+concept random_mapping = std::copyable<M>
+    && requires {
+        typename M::value_type;
+        { M::random_bits } -> std::convertible_to<unsigned>;
+    }
+    && (std::is_invocable_r_v<typename M::value_type, M const&, std::uint64_t>
+        || std::is_invocable_r_v<typename M::value_type, M const&, std::uint64_t, std::size_t>);
+
+namespace rng_detail {
+
+template <typename It, typename T>
+concept contiguous_iterator_to =
+        std::contiguous_iterator<It> && std::same_as<std::iter_value_t<It>, T>;
+
+/**
+ * Bijective mix of 64 bits -- the finalizer of SplitMix64.
+ * Used to draw a second number from the same random bits that is, in
+ * practice, independent from the first one.
+ */
+constexpr std::uint64_t remix(std::uint64_t x) noexcept
+{
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EB;
+    x ^= x >> 31;
+    return x;
+}
+
+/**
+ * Threshold such that `(bits >> 11) < threshold` holds with probability
+ * `p`, for uniform 64-bit `bits`.
+ * @pre `0 <= p <= 1`
+ */
+constexpr std::uint64_t probability_threshold(double p) noexcept
+{
+    return std::uint64_t(p * 0x1p53);
+}
+
+/**
+ * Counter-based [Philox4x32-10](https://www.thesalmons.org/john/random123/papers/random123sc11.pdf)
+ * generator run over `lanes` consecutive counters at once.
+ *
+ * Each counter is turned into 4 random 32-bit words that only depend on
+ * `(key, counter)`: there is no state to carry from one block to the next.
+ * The lanes are stored as a _structure of arrays_ so that each round is
+ * a loop without dependency between iterations, that compilers turn
+ * into SIMD instructions (32x32->64 multiplications, xors).
+ */
+template <std::size_t lanes>
+struct philox4x32
+{
+    using lane_type  = std::array<std::uint32_t, lanes>;
+    using block_type = std::array<lane_type, 4>;
+
+    static void generate(std::uint64_t key, std::uint64_t first_counter, block_type& x) noexcept
+    {
+        auto& [c0, c1, c2, c3] = x;
+        for (std::size_t l = 0; l < lanes; ++l) {
+            c0[l] = std::uint32_t(first_counter + l);
+            c1[l] = std::uint32_t((first_counter + l) >> 32);
+            c2[l] = 0;
+            c3[l] = 0;
+        }
+        auto k0 = std::uint32_t(key);
+        auto k1 = std::uint32_t(key >> 32);
+        for (int round = 0; round < 10; ++round) {
+            for (std::size_t l = 0; l < lanes; ++l) {
+                auto const p0 = std::uint64_t(0xD2511F53) * c0[l];
+                auto const p1 = std::uint64_t(0xCD9E8D57) * c2[l];
+                auto const n0 = std::uint32_t(p1 >> 32) ^ c1[l] ^ k0;
+                auto const n2 = std::uint32_t(p0 >> 32) ^ c3[l] ^ k1;
+                c1[l] = std::uint32_t(p1);
+                c3[l] = std::uint32_t(p0);
+                c0[l] = n0;
+                c2[l] = n2;
+            }
+            k0 += 0x9E3779B9;
+            k1 += 0xBB67AE85;
+        }
+    }
+};
+
+/**
+ * Counter-based sequence of random numbers, mapped by `Mapping`.
+ *
+ * The i-th number only depends on `(key, i)`. Instances are cheap to
+ * copy, and they can be shared by any number of threads.
+ */
+template <typename T, random_mapping Mapping = uniform_mapping_t<T>>
+class counter_based_sequence
 {
 public:
-  explicit RNG(T min_, T max_, int count_)
-    : m_device()
-    , m_engine(m_device())
-    , m_distribution(min_, max_)
-    , m_count(count_)
+    counter_based_sequence() = default;
+    counter_based_sequence(std::uint64_t key, Mapping mapping)
+    : m_mapping(std::move(mapping))
+    , m_key(key)
     {}
 
-  explicit RNG(int count)
+    T operator()(std::size_t index) const noexcept
+    {
+        typename single_engine_type::block_type x;
+        single_engine_type::generate(m_key, index / per_block, x);
+        return map(m_mapping, bits(x, 0, index % per_block), index);
+    }
+
+    void fill(std::span<T> out, std::size_t offset) const noexcept
+    {
+        // Local copies: the compiler doesn't have to assume `out` may alias
+        // them, which would prevent vectorization for char-like types.
+        auto const mapping = m_mapping;
+        auto const key     = m_key;
+
+        typename bulk_engine_type::block_type x;
+        std::size_t const n       = out.size();
+        std::size_t       i       = 0;
+        std::uint64_t     counter = offset / per_block;
+        std::size_t       skip    = offset % per_block;
+        while (i < n) {
+            bulk_engine_type::generate(key, counter, x);
+            std::size_t const count = std::min(per_batch - skip, n - i);
+            std::size_t const first = offset + i;
+            if (count == per_batch) {
+                for (std::size_t l = 0; l < bulk_lanes; ++l) {
+                    for (std::size_t w = 0; w < per_block; ++w) {
+                        auto const j = l * per_block + w;
+                        out[i + j] = map(mapping, bits(x, l, w), first + j);
+                    }
+                }
+            } else {
+                for (std::size_t j = 0; j < count; ++j) {
+                    out[i + j] = map(
+                            mapping, bits(x, (skip + j) / per_block, (skip + j) % per_block),
+                            first + j);
+                }
+            }
+            i       += count;
+            counter += bulk_lanes;
+            skip     = 0;
+        }
+    }
+
+    static constexpr std::size_t bulk_lanes = 32;
+    /// Numbers per Philox counter: 4 x 32 bits, or 2 x 64 bits.
+    static constexpr std::size_t per_block  = Mapping::random_bits <= 32 ? 4 : 2;
+    static constexpr std::size_t per_batch  = per_block * bulk_lanes;
+
+private:
+    using bulk_engine_type   = philox4x32<bulk_lanes>;
+    using single_engine_type = philox4x32<1>;
+
+    /// Random bits, left-aligned, for the `w`-th number of lane `l`.
+    template <typename Block>
+    static std::uint64_t bits(Block const& x, std::size_t l, std::size_t w) noexcept
+    {
+        if constexpr (per_block == 4) {
+            return std::uint64_t(x[w][l]) << 32;
+        } else {
+            return (std::uint64_t(x[2 * w][l]) << 32) | x[2 * w + 1][l];
+        }
+    }
+
+    static T map(Mapping const& mapping, std::uint64_t bits, std::size_t index) noexcept
+    {
+        if constexpr (std::is_invocable_v<Mapping const&, std::uint64_t, std::size_t>) {
+            return mapping(bits, index);
+        } else {
+            return mapping(bits);
+        }
+    }
+
+    Mapping       m_mapping;
+    std::uint64_t m_key = 0;
+};
+
+} // namespace rng_detail
+
+/**
+ * Data shapes other than uniform, for kernels whose performance depends
+ * on their inputs: branches, hashing, or floating-point assists.
+ * Use them as the `Mapping` of `RNG`:
+ *
+ * ```c++
+ * RNG(rng_seed{1}, zipf_mapping<std::uint32_t>(1'000'000, 1.1), count).fill_parallel(keys);
+ * ```
+ */
+
+/**
+ * Zipf-distributed keys: `min + k`, where the rank `k` in `[0, n)` is
+ * drawn with a probability proportional to `1 / (k + 1)^s`.
+ *
+ * The rank is obtained by inverting the continuous approximation of the
+ * cumulative distribution -- integral of `x^-s` from 1/2 -- without any
+ * loop nor data-dependent branch. The price is a bias on the very first
+ * keys: with `s` in `[1, 1.5]`, their frequencies are up to 10% off the
+ * exact Zipf law. The following ones are accurate.
+ */
+template <typename T>
+struct zipf_mapping {
+    static_assert(std::is_integral_v<T>, "Zipf keys are integral");
+
+    using value_type = T;
+    static constexpr unsigned random_bits = 64;
+
+    zipf_mapping() = default;
+    /**
+     * @param[in] n    Number of distinct keys.
+     * @param[in] s    Exponent; the bigger, the more skewed.
+     * @param[in] min  First key, the most frequent one.
+     * @pre `n > 0`, `s > 0`, and `min + n - 1` fits into `T`.
+     */
+    zipf_mapping(std::uint64_t n, double s, T min_ = T(0))
+    : m_min(min_)
+    , m_last(n - 1)
+    , m_harmonic(std::abs(s - 1) < 1e-9)
+    {
+        assert(n > 0 && s > 0);
+        double const lo = 0.5;
+        double const hi = double(n) + 0.5;
+        if (m_harmonic) {
+            m_scale = std::log(hi / lo);
+        } else {
+            m_offset   = std::pow(lo, 1 - s);
+            m_scale    = std::pow(hi, 1 - s) - m_offset;
+            m_exponent = 1 / (1 - s);
+        }
+    }
+
+    T operator()(std::uint64_t bits) const noexcept
+    {
+        double const u = double(bits >> 11) * 0x1p-53;
+        // x in [1/2, n + 1/2): rank k corresponds to [k + 1/2, k + 3/2)
+        double const x = m_harmonic
+            ? 0.5 * std::exp(u * m_scale)
+            : std::exp(m_exponent * std::log(std::fma(u, m_scale, m_offset)));
+        // Rounding may bring x just below 1/2 when u is close to 0
+        auto const rank = std::min(std::uint64_t(std::max(x, 0.5) + 0.5) - 1, m_last);
+        return static_cast<T>(m_min + rank);
+    }
+
+    friend auto operator<=>(zipf_mapping const&, zipf_mapping const&) = default;
+
+private:
+    T             m_min      = 0;
+    std::uint64_t m_last     = 0;
+    bool          m_harmonic = true;
+    double        m_offset   = 0;
+    double        m_scale    = 0;
+    double        m_exponent = 0;
+};
+
+/**
+ * Mostly sorted numbers: an ascending ramp from `min`, at index 0, to
+ * `max`, at index `count`, where a fraction `disorder` of the numbers are
+ * replaced by uniform ones in `[min, max]`.
+ *
+ * Numbers after `count` stay at `max`.
+ */
+template <typename T>
+struct mostly_sorted_mapping {
+    using value_type = T;
+    static constexpr unsigned random_bits = 64;
+
+    mostly_sorted_mapping() = default;
+    /**
+     * @pre `min <= max`, `count > 0`, `0 <= disorder <= 1`
+     */
+    mostly_sorted_mapping(T min_, T max_, std::size_t count, double disorder)
+    : m_uniform(min_, max_)
+    , m_scale(0x1p63 / double(count))
+    , m_threshold(rng_detail::probability_threshold(disorder))
+    {
+        assert(count > 0 && 0 <= disorder && disorder <= 1);
+    }
+
+    T operator()(std::uint64_t bits, std::size_t index) const noexcept
+    {
+        // The ramp is the uniform mapping of index / count...
+        auto const ramp_bits = std::uint64_t(std::min(double(index) * m_scale, max_ramp)) << 1;
+        T const    ramp      = m_uniform(ramp_bits);
+        // ... and the outliers are drawn from other bits than their selection
+        T const    outlier   = m_uniform(rng_detail::remix(bits));
+        return (bits >> 11) < m_threshold ? outlier : ramp;
+    }
+
+    friend auto operator<=>(mostly_sorted_mapping const&, mostly_sorted_mapping const&) = default;
+
+private:
+    // Biggest double below 2^63: its conversion to 64 bits can't overflow once shifted
+    static constexpr double max_ramp = 0x1.fffffffffffffp62;
+
+    uniform_mapping_t<T> m_uniform;
+    double               m_scale     = 0;
+    std::uint64_t        m_threshold = 0;
+};
+
+/**
+ * Uniform floating-point numbers in `[min, max]`, where a fraction of
+ * them are replaced by positive denormals, and another fraction by NaNs.
+ * Arithmetic on such special values may take microcode assists.
+ */
+template <typename T>
+struct special_values_mapping {
+    static_assert(std::numeric_limits<T>::is_iec559 && (sizeof(T) == 4 || sizeof(T) == 8),
+                  "Special values are only defined for IEEE-754 float and double");
+
+    using value_type = T;
+    using bits_type  = std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>;
+    static constexpr unsigned random_bits = 64;
+
+    special_values_mapping() = default;
+    /**
+     * @pre `min <= max`, `denormals >= 0`, `nans >= 0`, `denormals + nans <= 1`
+     */
+    special_values_mapping(T min_, T max_, double denormals, double nans)
+    : m_uniform(min_, max_)
+    , m_nans(rng_detail::probability_threshold(nans))
+    , m_specials(rng_detail::probability_threshold(denormals + nans))
+    {
+        assert(denormals >= 0 && nans >= 0 && denormals + nans <= 1);
+    }
+
+    T operator()(std::uint64_t bits) const noexcept
+    {
+        constexpr int mantissa_bits = std::numeric_limits<T>::digits - 1;
+        auto const    selector      = rng_detail::remix(bits) >> 11;
+        // Exponent 0 and a non-null mantissa
+        T const denormal = std::bit_cast<T>(bits_type(bits >> (64 - mantissa_bits)) | 1);
+        T const value    = m_uniform(bits);
+        return selector < m_nans     ? std::numeric_limits<T>::quiet_NaN()
+             : selector < m_specials ? denormal
+             :                         value;
+    }
+
+    friend auto operator<=>(special_values_mapping const&, special_values_mapping const&) = default;
+
+private:
+    uniform_mapping_t<T> m_uniform;
+    std::uint64_t        m_nans     = 0;
+    std::uint64_t        m_specials = 0;
+};
+
+/**
+ * Bernoulli draws: `taken` with probability `ratio`, `not_taken`
+ * otherwise.
+ * For branches on the data that are taken with a fixed ratio.
+ */
+template <typename T>
+struct bernoulli_mapping {
+    using value_type = T;
+    static constexpr unsigned random_bits = 32;
+
+    bernoulli_mapping() = default;
+    /**
+     * @pre `0 <= ratio <= 1`
+     */
+    explicit bernoulli_mapping(double ratio, T taken = T(1), T not_taken = T(0))
+    : m_threshold(rng_detail::probability_threshold(ratio))
+    , m_taken(taken)
+    , m_not_taken(not_taken)
+    {
+        assert(0 <= ratio && ratio <= 1);
+    }
+
+    T operator()(std::uint64_t bits) const noexcept
+    {
+        return (bits >> 11) < m_threshold ? m_taken : m_not_taken;
+    }
+
+    friend auto operator<=>(bernoulli_mapping const&, bernoulli_mapping const&) = default;
+
+private:
+    std::uint64_t m_threshold = 0;
+    T             m_taken     = T(1);
+    T             m_not_taken = T(0);
+};
+
+/**
+ * Seed for the deterministic mode of `RNG`.
+ * Wrapped in a type to prevent any confusion with the `min`/`max`
+ * parameters.
+ */
+struct rng_seed
+{
+    std::uint64_t value;
+};
+
+
+/**
+ * Sized random-access view of `count` random numbers in `[min, max]`.
+ *
+ * The i-th element is computed on the fly from `(seed, i)` by a
+ * counter-based generator: the view stores no number, it's cheap to
+ * copy, and its iterators don't refer to it (it's a _borrowed range_).
+ *
+ * Numbers are uniformly distributed by default. Other data shapes are
+ * given as a `Mapping`, see `random_mapping`, `zipf_mapping`,
+ * `mostly_sorted_mapping`, `special_values_mapping`, and
+ * `bernoulli_mapping`.
+ *
+ * As the size is known, `test_vector<T>(rng.begin(), rng.end())`, or
+ * `std::ranges::to<test_vector<T>>()`, allocate only once. Still,
+ * `fill()` and `fill_parallel()` are much faster ways to produce big
+ * datasets as they generate the numbers by vectorized blocks.
+ */
+template <typename T, random_mapping Mapping = uniform_mapping_t<T>>
+class RNG : public std::ranges::view_interface<RNG<T, Mapping>>
+{
+  static_assert(std::same_as<typename Mapping::value_type, T>);
+  using sequence_type = rng_detail::counter_based_sequence<T, Mapping>;
+
+public:
+  /**
+   * Non reproducible mode: the seed is drawn from `std::random_device`.
+   */
+  explicit RNG(T min_, T max_, std::size_t count_)
+    : RNG(rng_seed{random_seed()}, min_, max_, count_)
+    {}
+
+  explicit RNG(std::size_t count)
       : RNG(std::numeric_limits<T>::min(), std::numeric_limits<T>::max(), count)
       {}
 
-  struct iterator {
-    typedef std::forward_iterator_tag iterator_category;
-    typedef std::ptrdiff_t            difference_type;
-    typedef T                         value_type;
-    typedef T*                        pointer;
-    typedef T&                        reference;
+  /**
+   * Deterministic mode.
+   * The i-th number only depends on `(seed, i)`: the same data is
+   * produced on every run, on every machine, whatever the number of
+   * threads used to produce it.
+   */
+  explicit RNG(rng_seed seed, T min_, T max_, std::size_t count_)
+    : RNG(seed, Mapping(min_, max_), count_)
+    {}
+
+  explicit RNG(rng_seed seed, std::size_t count)
+      : RNG(seed, std::numeric_limits<T>::min(), std::numeric_limits<T>::max(), count)
+      {}
+
+  /**
+   * Numbers shaped by `mapping`, non reproducible mode.
+   */
+  explicit RNG(Mapping mapping, std::size_t count_)
+    : RNG(rng_seed{random_seed()}, std::move(mapping), count_)
+    {}
+
+  /**
+   * Numbers shaped by `mapping`, deterministic mode.
+   */
+  explicit RNG(rng_seed seed, Mapping mapping, std::size_t count_)
+    : m_sequence(seed.value, std::move(mapping))
+    , m_count(count_)
+    {}
+
+  /**
+   * Random-access iterator over the numbers of a `RNG`.
+   * Dereferencing computes the number: `reference` is a prvalue `T`, as
+   * for `std::ranges::iota_view`.
+   * @note `iterator_category` is nonetheless declared random access, so
+   * that legacy algorithms and containers constructors can use
+   * `std::distance()` to pre-size their storage.
+   */
+  class iterator {
+  public:
+    using iterator_concept  = std::random_access_iterator_tag;
+    using iterator_category = std::random_access_iterator_tag;
+    using difference_type   = std::ptrdiff_t;
+    using value_type        = T;
+    using pointer           = void;
+    using reference         = T;
+
+    iterator() = default;
+    iterator(sequence_type const& sequence_, std::size_t index_)
+      : sequence(sequence_), index(index_) {}
+
+    T operator*() const noexcept { return sequence(index); }
+    T operator[](difference_type n) const noexcept { return sequence(index + n); }
+
+    iterator& operator++()    { ++index; return *this; }
+    iterator  operator++(int) { iterator tmp = *this; ++(*this); return tmp; }
+    iterator& operator--()    { --index; return *this; }
+    iterator  operator--(int) { iterator tmp = *this; --(*this); return tmp; }
+    iterator& operator+=(difference_type n) { index += n; return *this; }
+    iterator& operator-=(difference_type n) { index -= n; return *this; }
 
-    explicit iterator(RNG const& rng_, int count_) : rng(rng_), count(count_){}
-    T operator*() const { return rng.generate(); }
+    friend iterator operator+(iterator it, difference_type n) { return it += n; }
+    friend iterator operator+(difference_type n, iterator it) { return it += n; }
+    friend iterator operator-(iterator it, difference_type n) { return it -= n; }
+    friend difference_type operator-(iterator const& lhs, iterator const& rhs) {
+      return difference_type(lhs.index) - difference_type(rhs.index);
+    }
     friend bool operator==(iterator const& lhs, iterator const& rhs) {
-      assert(&lhs.rng == &rhs.rng);
-      return lhs.count == rhs.count;
+      return lhs.index == rhs.index;
     }
-    friend bool operator!=(iterator const& lhs, iterator const& rhs) {
-      return !(lhs == rhs);
+    friend auto operator<=>(iterator const& lhs, iterator const& rhs) {
+      return lhs.index <=> rhs.index;
     }
-    iterator& operator++()    { --count; return *this; }
-    iterator  operator++(int) { iterator tmp; ++(*this); return tmp; }
   private:
-    RNG const& rng;
-    int        count;
+    sequence_type sequence;
+    std::size_t   index = 0;
   };
 
-  iterator begin() const { return iterator{*this, m_count}; }
-  iterator end  () const { return iterator{*this, 0};       }
+  iterator    begin() const noexcept { return iterator{m_sequence, 0};       }
+  iterator    end  () const noexcept { return iterator{m_sequence, m_count}; }
+  std::size_t size () const noexcept { return m_count; }
+
+  /**
+   * Returns the `index`-th number of the counter-based sequence.
+   * It's valid even beyond `size()`.
+   * @throw None
+   */
+  T generate_at(std::size_t index) const noexcept { return m_sequence(index); }
+
+  /**
+   * Fills `out` with the numbers `[offset, offset + out.size())` of the
+   * counter-based sequence.
+   *
+   * This is the fast path to initialize big datasets: the numbers are
+   * produced by blocks of Philox4x32-10 counters, and they are mapped
+   * into `[min, max]`, or by `Mapping`, without any branch. Both loops
+   * are meant to be vectorized.
+   *
+   * As the numbers only depend on their index, calling `fill()` twice
+   * with the same offset yields the same numbers. Use distinct offsets,
+   * or distinct instances, to obtain different datasets.
+   * @param[out] out     Contiguous range to fill -- `out.size()`
+   *                     numbers are generated, independently of the
+   *                     `count` given to the constructor.
+   * @param[in]  offset  Index of the first number to generate.
+   * @throw None
+   */
+  void fill(std::span<T> out, std::size_t offset = 0) const noexcept
+  {
+    m_sequence.fill(out, offset);
+  }
+
+  /**
+   * Multi-threaded version of `fill()`.
+   * `out` is split into `jobs` disjoint chunks filled concurrently. The
+   * result is identical to `fill(out, offset)` whatever `jobs` is.
+   * @param[out] out     Contiguous range to fill.
+   * @param[in]  jobs    Number of threads to use, 0 means
+   *                     `std::thread::hardware_concurrency()`.
+   * @param[in]  offset  Index of the first number to generate.
+   * @throw std::system_error if threads cannot be started.
+   */
+  void fill_parallel(std::span<T> out, unsigned jobs = 0, std::size_t offset = 0) const
+  {
+    if (jobs == 0) jobs = std::max(1u, std::thread::hardware_concurrency());
+    // Not worth starting threads for small datasets
+    jobs = unsigned(std::min<std::size_t>(jobs, out.size() / min_parallel_chunk + 1));
+    // Chunks are multiples of a batch to keep every thread on the fast path
+    auto const        per_batch = sequence_type::per_batch;
+    std::size_t const chunk
+      = (out.size() / jobs + per_batch - 1) / per_batch * per_batch;
+    if (jobs == 1 || chunk == 0) {
+      fill(out, offset);
+      return;
+    }
+
+    // Joined on destruction: the threads already started are also joined
+    // when another one cannot be
+    std::vector<std::jthread> workers;
+    workers.reserve(jobs);
+    for (std::size_t first = chunk; first < out.size(); first += chunk) {
+      auto const sub = out.subspan(first, std::min(chunk, out.size() - first));
+      workers.emplace_back([this, sub, first, offset] { fill(sub, offset + first); });
+    }
+    fill(out.first(std::min(chunk, out.size())), offset);
+  }
 
-  T generate() const { return m_distribution(m_engine); }
+  /**
+   * Writes `n` random numbers through `first`.
+   * Contiguous output iterators are directly forwarded to `fill()`,
+   * other iterators are fed through a small intermediary buffer.
+   * @param[in] offset  Index of the first number to generate.
+   * @return the iterator past the last element written.
+   * @throw Whatever assigning through `first` may throw.
+   */
+  template <typename OutputIt>
+  OutputIt generate_n(OutputIt first, std::size_t n, std::size_t offset = 0) const
+  {
+    if constexpr (rng_detail::contiguous_iterator_to<OutputIt, T>) {
+      fill(std::span<T>(std::to_address(first), n), offset);
+      return first + n;
+    } else {
+      std::array<T, 1024> buffer;
+      while (n > 0) {
+        auto const chunk = std::min(n, buffer.size());
+        fill(std::span<T>(buffer.data(), chunk), offset);
+        first = std::copy_n(buffer.begin(), chunk, first);
+        n      -= chunk;
+        offset += chunk;
+      }
+      return first;
+    }
+  }
 
 private:
-  std::random_device               mutable m_device;
-  std::default_random_engine       mutable m_engine;
-  uniform_distribution_t<T>        mutable m_distribution;
-  int                                      m_count;
+  static constexpr std::size_t min_parallel_chunk = std::size_t(1) << 16;
+
+  static std::uint64_t random_seed()
+  {
+    std::random_device device;
+    return (std::uint64_t(device()) << 32) | device();
+  }
+
+  sequence_type m_sequence;
+  std::size_t   m_count;
 };
 
+template <random_mapping Mapping>
+RNG(Mapping, std::size_t) -> RNG<typename Mapping::value_type, Mapping>;
+template <random_mapping Mapping>
+RNG(rng_seed, Mapping, std::size_t) -> RNG<typename Mapping::value_type, Mapping>;
+
+/// Iterators don't refer to the `RNG` they come from.
+template <typename T, typename Mapping>
+inline constexpr bool std::ranges::enable_borrowed_range<RNG<T, Mapping>> = true;
+
 #endif // random_ranges_hpp
@@ -0,0 +1,393 @@
+// Vectors for benchmark working sets, with page placement control.
+// ======================================================================
+// Copyright (c) 2025 CS GROUP
+//
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// ======================================================================
+//
+// Authors:
+// - Luc Hermitte, initial author
+//
+// ======================================================================
+//
+// Defines:
+// - PageSize, page_policy: how test_vector memory is mapped.
+// - PageArena: the allocator back-end, that maps memory according to
+//   the policy, and remembers the page size every allocation got.
+// - page_arena(): accessor to the process-wide instance.
+// - arena_allocator<T>: cache-line aligned allocator over the arena.
+// - test_vector<T>: std::vector that uses arena_allocator.
+// - record_pages(): stores the page size in effect in a Bench context.
+
+#ifndef test_vector_hpp
+#define test_vector_hpp
+
+#include "cache_topology.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <new>
+#include <string>
+#include <vector>
+
+#if __has_include(<sys/mman.h>) && __has_include(<unistd.h>)
+#  include <sys/mman.h>
+#  include <sys/syscall.h>
+#  include <unistd.h>
+#  define TEST_VECTOR_HAS_MMAP
+#endif
+
+#if defined(LEVEL1_DCACHE_LINESIZE)
+constexpr std::size_t hardware_constructive_interference_size = LEVEL1_DCACHE_LINESIZE;
+#elif defined(__cpp_lib_hardware_interference_size)
+constexpr std::size_t hardware_constructive_interference_size =
+        std::hardware_constructive_interference_size;
+#else
+constexpr std::size_t hardware_constructive_interference_size = 64;
+#endif
+
+/** Pages `test_vector` memory is mapped with. */
+enum class PageSize
+{
+    normal,      ///< Whatever `operator new` returns
+    transparent, ///< Transparent huge pages, through `MADV_HUGEPAGE`
+    huge_2M,     ///< 2 MiB `MAP_HUGETLB` pages, THP as a fallback
+    huge_1G,     ///< 1 GiB `MAP_HUGETLB` pages, THP as a fallback
+};
+
+/** How `test_vector` memory is obtained. */
+struct page_policy
+{
+    PageSize page_size = PageSize::normal;
+    bool     prefault  = false; ///< Touch every page when allocated
+    int      numa_node = -1;    ///< Bind memory to this node, if not -1
+
+    /** Whether the memory has to be mapped by the arena itself. */
+    [[nodiscard]] bool mapped() const noexcept
+    {
+        return page_size != PageSize::normal || prefault || numa_node >= 0;
+    }
+};
+
+/**
+ * Back-end of `arena_allocator`.
+ *
+ * With the default policy, memory comes from the aligned `operator
+ * new`. Otherwise, each allocation is an anonymous `mmap()`:
+ * - with `MAP_HUGETLB` pages when asked -- `/proc/sys/vm/nr_hugepages`
+ *   or `hugepagesz=1G hugepages=N` on the kernel command line shall
+ *   reserve some --, or else with 2 MiB aligned memory advised with
+ *   `MADV_HUGEPAGE`;
+ * - bound to a NUMA node with `mbind()`, before the first touch;
+ * - and prefaulted, so that no page fault is left for the benchmarks
+ *   to pay.
+ *
+ * The page size every mapping got is remembered: `describe()` reports
+ * what was actually in effect, fallbacks included.
+ *
+ * This class is neither copiable nor moveable. All its functions can
+ * be called concurrently.
+ */
+class PageArena
+{
+public:
+    PageArena() = default;
+    PageArena(PageArena const&)            = delete;
+    PageArena& operator=(PageArena const&) = delete;
+
+    /** Policy applied to the next allocations. */
+    [[nodiscard]]
+    page_policy policy() const
+    {
+        std::lock_guard lock(m_mutex);
+        return m_policy;
+    }
+
+    /**
+     * Changes the policy of the next allocations.
+     * Current allocations are left untouched.
+     */
+    void policy(page_policy p)
+    {
+        std::lock_guard lock(m_mutex);
+        m_policy = p;
+    }
+
+    /**
+     * Allocates `bytes` bytes aligned on `alignment`.
+     * @throw std::bad_alloc if memory is exhausted.
+     * @pre `alignment` is a power of 2.
+     */
+    [[nodiscard]]
+    void* allocate(std::size_t bytes, std::size_t alignment)
+    {
+        page_policy const p = policy();
+#if defined(TEST_VECTOR_HAS_MMAP)
+        if (p.mapped() && alignment <= base_page_size()) {
+            mapping     m{};
+            void* const addr = map(std::max<std::size_t>(bytes, 1), p, m);
+            std::lock_guard lock(m_mutex);
+            m_mappings.emplace(addr, m);
+            return addr;
+        }
+#endif
+        return ::operator new(bytes, std::align_val_t{alignment});
+    }
+
+    /**
+     * Releases memory returned by `allocate()`.
+     * @throw None
+     */
+    void deallocate(void* addr, std::size_t bytes, std::size_t alignment) noexcept
+    {
+        {
+            std::lock_guard lock(m_mutex);
+            if (auto const it = m_mappings.find(addr); it != m_mappings.end()) {
+#if defined(TEST_VECTOR_HAS_MMAP)
+                ::munmap(addr, it->second.length);
+#endif
+                m_mappings.erase(it);
+                return;
+            }
+        }
+        ::operator delete(addr, bytes, std::align_val_t{alignment});
+    }
+
+    /**
+     * Describes the pages of the live allocations: "2 MiB", "4 KiB +
+     * THP", "1 GiB on node 0"...
+     * When the arena doesn't map anything, the base page size is
+     * reported -- with THP if the system enables them for everything.
+     * @throw std::bad_alloc if memory is exhausted. Unlikely.
+     */
+    [[nodiscard]]
+    std::string describe() const
+    {
+        std::vector<std::string> labels;
+        {
+            std::lock_guard lock(m_mutex);
+            for (auto const& [addr, m] : m_mappings) {
+                std::string l = label(m);
+                if (std::find(labels.begin(), labels.end(), l) == labels.end()) {
+                    labels.push_back(std::move(l));
+                }
+            }
+        }
+        if (labels.empty()) {
+            return human_bytes(base_page_size()) + (thp_mode() == "always" ? " + THP" : "");
+        }
+        std::string res;
+        for (auto const& l : labels) res += (res.empty() ? "" : ", ") + l;
+        return res;
+    }
+
+    /** Size of normal pages. */
+    static std::size_t base_page_size() noexcept
+    {
+#if __has_include(<unistd.h>)
+        static std::size_t const size = std::size_t(::sysconf(_SC_PAGESIZE));
+        return size;
+#else
+        return 4096;
+#endif
+    }
+
+private:
+    struct mapping
+    {
+        std::size_t length;    ///< Mapped bytes
+        std::size_t page_size; ///< Of the `MAP_HUGETLB` pages, or the base pages
+        bool        thp;       ///< Advised with `MADV_HUGEPAGE`
+        int         node;      ///< Bound NUMA node, -1 if none
+    };
+
+    /// "always", "madvise", or "never", as set in sysfs.
+    static std::string const& thp_mode()
+    {
+        static std::string const mode = [] {
+            std::ifstream f("/sys/kernel/mm/transparent_hugepage/enabled");
+            std::string   word;
+            while (f >> word) {
+                if (word.size() > 2 && word.front() == '[') return word.substr(1, word.size() - 2);
+            }
+            return std::string("never");
+        }();
+        return mode;
+    }
+
+    static std::string label(mapping const& m)
+    {
+        std::string res = human_bytes(m.page_size) + (m.thp ? " + THP" : "");
+        if (m.node >= 0) res += " on node " + std::to_string(m.node);
+        return res;
+    }
+
+    static std::size_t round_up(std::size_t bytes, std::size_t granularity) noexcept
+    {
+        return (bytes + granularity - 1) / granularity * granularity;
+    }
+
+#if defined(TEST_VECTOR_HAS_MMAP)
+    static constexpr std::size_t thp_size = std::size_t(2) << 20;
+
+    /// Maps `bytes` bytes according to `p`, and describes it in `m`.
+    static void* map(std::size_t bytes, page_policy const& p, mapping& m)
+    {
+        void* addr = MAP_FAILED;
+#  if defined(MAP_HUGETLB) && defined(MAP_HUGE_SHIFT)
+        if (p.page_size == PageSize::huge_2M || p.page_size == PageSize::huge_1G) {
+            int const log2_size = p.page_size == PageSize::huge_1G ? 30 : 21;
+            m.page_size         = std::size_t(1) << log2_size;
+            m.length            = round_up(bytes, m.page_size);
+            addr                = ::mmap(
+                    nullptr, m.length, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | (log2_size << MAP_HUGE_SHIFT), -1, 0);
+        }
+#  endif
+        if (addr == MAP_FAILED) {
+            // Normal pages, with THP if asked -- or if huge pages aren't
+            // available. THP need 2 MiB aligned ranges: map more, and
+            // trim both ends.
+            bool const        thp    = p.page_size != PageSize::normal;
+            std::size_t const align  = thp ? thp_size : base_page_size();
+            m.page_size              = base_page_size();
+            m.length                 = round_up(bytes, align);
+            std::size_t const mapped = m.length + (thp ? thp_size : 0);
+            auto* const       raw    = static_cast<char*>(::mmap(
+                    nullptr, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+            if (raw == MAP_FAILED) throw std::bad_alloc();
+            auto* const first = reinterpret_cast<char*>(
+                    round_up(reinterpret_cast<std::uintptr_t>(raw), align));
+            if (first != raw) ::munmap(raw, std::size_t(first - raw));
+            if (std::size_t const tail = std::size_t(raw + mapped - (first + m.length))) {
+                ::munmap(first + m.length, tail);
+            }
+            addr = first;
+#  if defined(MADV_HUGEPAGE)
+            m.thp = thp && thp_mode() != "never" && ::madvise(addr, m.length, MADV_HUGEPAGE) == 0;
+#  endif
+        }
+        m.node = p.numa_node >= 0 && bind(addr, m.length, p.numa_node) ? p.numa_node : -1;
+        if (p.prefault) {
+            // One write per page is enough
+            auto* const bytes_ptr = static_cast<volatile char*>(addr);
+            for (std::size_t i = 0; i < m.length; i += base_page_size()) bytes_ptr[i] = 0;
+        }
+        return addr;
+    }
+
+    /// `mbind(MPOL_BIND)` without libnuma.
+    static bool bind(void* addr, std::size_t length, int node) noexcept
+    {
+#  if defined(SYS_mbind)
+        constexpr int     mpol_bind = 2;
+        constexpr int     bits      = std::numeric_limits<unsigned long>::digits;
+        std::size_t const words     = std::size_t(node) / bits + 1;
+        unsigned long     mask[16]  = {};
+        if (words > std::size(mask)) return false;
+        mask[node / bits] = 1UL << (node % bits);
+        return ::syscall(SYS_mbind, addr, length, mpol_bind, mask, words * bits + 1, 0) == 0;
+#  else
+        (void)addr, (void)length, (void)node;
+        return false;
+#  endif
+    }
+#endif
+
+    page_policy                    m_policy;
+    std::map<void const*, mapping> m_mappings;
+    mutable std::mutex             m_mutex;
+};
+
+/**
+ * Process-wide `PageArena` shared by every `test_vector`.
+ * @throw None
+ */
+inline PageArena& page_arena()
+{
+    static PageArena arena;
+    return arena;
+}
+
+/**
+ * Allocator of `test_vector`: memory aligned on `alignment` -- a cache
+ * line by default --, obtained from `page_arena()`.
+ */
+template <typename T, std::size_t alignment = hardware_constructive_interference_size>
+struct arena_allocator
+{
+    using value_type = T;
+
+    template <typename U>
+    struct rebind
+    {
+        using other = arena_allocator<U, alignment>;
+    };
+
+    arena_allocator() = default;
+    template <typename U>
+    arena_allocator(arena_allocator<U, alignment> const&) noexcept {}
+
+    [[nodiscard]]
+    T* allocate(std::size_t n)
+    {
+        if (n > std::numeric_limits<std::size_t>::max() / sizeof(T)) throw std::bad_array_new_length();
+        return static_cast<T*>(page_arena().allocate(n * sizeof(T), align()));
+    }
+
+    void deallocate(T* p, std::size_t n) noexcept
+    {
+        page_arena().deallocate(p, n * sizeof(T), align());
+    }
+
+    friend bool operator==(arena_allocator const&, arena_allocator const&) noexcept
+    {
+        return true;
+    }
+
+private:
+    static constexpr std::size_t align() noexcept { return std::max(alignment, alignof(T)); }
+};
+
+template <typename T, std::size_t alignment = hardware_constructive_interference_size>
+using test_vector = std::vector<T, arena_allocator<T, alignment>>;
+
+/**
+ * Records, as the "pages" context variable of `bench`, the pages of the
+ * `test_vector`s that are alive.
+ * Meant to be called right before `Bench::run()`: the results keep the
+ * value, and `HtmlGraphRenderer::showcontext({"pages"})` displays it.
+ * @tparam Bench  `ankerl::nanobench::Bench`.
+ */
+template <typename Bench>
+void record_pages(Bench& bench)
+{
+    bench.context("pages", page_arena().describe());
+}
+
+#endif // test_vector_hpp
@@ -0,0 +1,288 @@
+// Multi-threaded scaling benchmarks.
+// ======================================================================
+// Copyright (c) 2025 CS GROUP
+//
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// ======================================================================
+//
+// Authors:
+// - Luc Hermitte, initial author
+//
+// ======================================================================
+//
+// Defines:
+// - ThreadScaling: runs a kernel on an increasing number of pinned
+//   threads, and describes the resulting throughput LinePlot next to
+//   the ideal linear scaling.
+
+#ifndef thread_scaling_hpp
+#define thread_scaling_hpp
+
+#include "cpu_affinity.hpp"
+#include "nanobench_html_graph_renderer.hpp"
+#include "test_vector.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <barrier>
+#include <cstddef>
+#include <exception>
+#include <optional>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * Runs kernels on 1 to N threads, and measures the aggregate
+ * throughput.
+ *
+ * For each thread count, a team of threads is started, each pinned to
+ * its own core. Every thread calls `setup` from the core it's pinned
+ * to: with the Linux _first touch_ policy, the buffers it allocates and
+ * initializes are then local to its NUMA node. Then, each time nanobench
+ * calls the benchmarked function, all the threads are released at once
+ * by a barrier, execute their kernel, and the measure stops when the
+ * last one is done.
+ *
+ * The barriers cost a few microseconds: the kernels shall run much
+ * longer than that.
+ *
+ * ```c++
+ * ThreadScaling scaling;
+ * scaling.run(bench, "triad", count, [=](unsigned thread, unsigned nb_threads) {
+ *     ... allocate and initialize this thread's data ...
+ *     return [=]() mutable { ... kernel ... };
+ * });
+ * render_line_graph(bench, scaling.plot(), "triad-scaling");
+ * ```
+ */
+class ThreadScaling
+{
+public:
+    /**
+     * Powers of 2 up to `max_threads`, and `max_threads` itself.
+     * @throw std::bad_alloc if memory is exhausted.
+     */
+    [[nodiscard]]
+    static std::vector<unsigned> default_thread_counts(unsigned max_threads)
+    {
+        std::vector<unsigned> counts;
+        for (unsigned n = 1; n < max_threads; n *= 2) counts.push_back(n);
+        counts.push_back(std::max(1u, max_threads));
+        return counts;
+    }
+
+    /**
+     * Constructs a scaling study over the cores in `cpus`, up to one
+     * thread per core. The threads aren't pinned if `cpus` is empty:
+     * there are then as many as `std::thread::hardware_concurrency()`.
+     * @throw std::bad_alloc if memory is exhausted.
+     */
+    explicit ThreadScaling(std::vector<int> cpus = allowed_cpus())
+    : m_cpus(std::move(cpus))
+    , m_thread_counts(default_thread_counts(core_count(m_cpus)))
+    {
+        init_plot();
+    }
+
+    /**
+     * Constructs a scaling study over explicit thread counts.
+     * Threads are pinned round-robin over `cpus`, if it isn't empty.
+     * @throw std::bad_alloc if memory is exhausted.
+     */
+    ThreadScaling(std::vector<int> cpus, std::vector<unsigned> thread_counts)
+    : m_cpus(std::move(cpus))
+    , m_thread_counts(std::move(thread_counts))
+    {
+        init_plot();
+    }
+
+    /**
+     * Benchmarks one kernel for every thread count.
+     *
+     * @tparam Setup  Callable taking `(unsigned thread, unsigned nb_threads)`
+     *                and returning the nullary callable that thread runs.
+     *                It's called concurrently from all the threads.
+     * @param[in,out] bench             Benchmark object where results are
+     *                                  appended. Its `batch()` is set to
+     *                                  the total number of units.
+     * @param[in]     series            Name of the kernel; the number of
+     *                                  threads is appended to it for each
+     *                                  individual result.
+     * @param[in]     units_per_thread  Work done by each kernel call.
+     * @param[in]     setup             Prepares the data of one thread.
+     * @return *this
+     * @throw std::system_error if threads cannot be started.
+     * @throw Whatever `setup` or `Bench::run()` may throw.
+     */
+    template <typename Setup>
+    ThreadScaling& run(
+            ankerl::nanobench::Bench& bench, std::string const& series,
+            std::size_t units_per_thread, Setup&& setup)
+    {
+        using Op = std::invoke_result_t<Setup&, unsigned, unsigned>;
+        static_assert(std::is_invocable_v<Op&>, "setup shall return the kernel to run");
+
+        LinePlot::Series measured;
+        measured.name = series;
+        for (auto const n : m_thread_counts) {
+            team<Op> t(n, m_cpus, setup);
+            t.rethrow_setup_error();
+            record_pages(bench);
+            bench.batch(units_per_thread * n);
+            measured.results.push_back(bench.results().size());
+            measured.x.push_back(double(n));
+            bench.run(series + " " + std::to_string(n) + " threads", [&t]() { t.step(); });
+        }
+
+        // Linear scaling from the first thread count, in units per second:
+        // nanobench measures the time of a step, that processes `batch()` units
+        LinePlot::Series ideal;
+        ideal.name = series + " (ideal)";
+        ideal.dash = "dash";
+        if (!measured.results.empty()) {
+            using Measure = ankerl::nanobench::Result::Measure;
+            auto const&  r     = bench.results().at(measured.results.front());
+            double const first = r.config().mBatch / r.median(Measure::elapsed) / measured.x.front();
+            for (auto const x : measured.x) {
+                ideal.x.push_back(x);
+                ideal.y.push_back(first * x);
+            }
+        }
+        m_plot.series.push_back(std::move(measured));
+        m_plot.series.push_back(std::move(ideal));
+        return *this;
+    }
+
+    [[nodiscard]] std::vector<int> const& cpus() const noexcept { return m_cpus; }
+    [[nodiscard]] std::vector<unsigned> const& thread_counts() const noexcept { return m_thread_counts; }
+
+    /** Throughput plot of all the kernels run so far. */
+    [[nodiscard]] LinePlot const& plot() const noexcept { return m_plot; }
+
+private:
+    /**
+     * Pinned threads that run their kernel each time `step()` is called.
+     * The threads are stopped and joined on destruction.
+     */
+    template <typename Op>
+    class team
+    {
+    public:
+        template <typename Setup>
+        team(unsigned nb_threads, std::vector<int> const& cpus, Setup& setup)
+        : m_start(nb_threads + 1)
+        , m_done(nb_threads + 1)
+        , m_errors(nb_threads)
+        {
+            m_threads.reserve(nb_threads);
+            try {
+                for (unsigned i = 0; i < nb_threads; ++i) {
+                    int const cpu = cpus.empty() ? -1 : cpus[i % cpus.size()];
+                    m_threads.emplace_back([this, i, nb_threads, cpu, &setup]() {
+                        work(i, nb_threads, cpu, setup);
+                    });
+                }
+            } catch (...) {
+                // Threads that couldn't start won't take part in the barriers
+                for (auto i = m_threads.size(); i < nb_threads; ++i) {
+                    m_start.arrive_and_drop();
+                    m_done.arrive_and_drop();
+                }
+                m_start.arrive_and_wait();
+                stop();
+                throw;
+            }
+            m_start.arrive_and_wait(); // Every setup is done
+        }
+
+        team(team const&)            = delete;
+        team& operator=(team const&) = delete;
+
+        ~team() { stop(); }
+
+        void rethrow_setup_error() const
+        {
+            for (auto const& e : m_errors) {
+                if (e) std::rethrow_exception(e);
+            }
+        }
+
+        /** Runs the kernel once on every thread. */
+        void step()
+        {
+            m_start.arrive_and_wait();
+            m_done.arrive_and_wait();
+        }
+
+    private:
+        template <typename Setup>
+        void work(unsigned i, unsigned nb_threads, int cpu, Setup& setup)
+        {
+            if (cpu >= 0) pin_to_cpu(cpu);
+            std::optional<Op> op;
+            try {
+                op.emplace(setup(i, nb_threads));
+            } catch (...) {
+                m_errors[i] = std::current_exception();
+            }
+            m_start.arrive_and_wait();
+            for (;;) {
+                m_start.arrive_and_wait();
+                if (m_stop.load(std::memory_order_relaxed)) break;
+                if (op) (*op)();
+                m_done.arrive_and_wait();
+            }
+        }
+
+        void stop()
+        {
+            if (m_threads.empty()) return;
+            m_stop = true;
+            m_start.arrive_and_wait();
+            for (auto& t : m_threads) t.join();
+            m_threads.clear();
+        }
+
+        std::barrier<>                  m_start;
+        std::barrier<>                  m_done;
+        std::atomic<bool>               m_stop{false};
+        std::vector<std::exception_ptr> m_errors;
+        std::vector<std::thread>        m_threads;
+    };
+
+    void init_plot()
+    {
+        m_plot.x_title    = "threads";
+        m_plot.log_x      = false;
+        m_plot.throughput = true;
+    }
+
+    std::vector<int>      m_cpus;
+    std::vector<unsigned> m_thread_counts;
+    LinePlot              m_plot;
+};
+
+#endif // thread_scaling_hpp
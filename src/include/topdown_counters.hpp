@@ -0,0 +1,502 @@
+// Top-down microarchitecture analysis with grouped perf_event counters.
+// ======================================================================
+// Copyright (c) 2025 CS GROUP
+//
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// ======================================================================
+//
+// Authors:
+// - Luc Hermitte, initial author
+//
+// ======================================================================
+//
+// Defines:
+// - TopdownCounters: perf_event groups of the calling thread, that
+//   measure the top-down level 1 -- and 2 when available -- slots, and
+//   the L1D and LLC misses.
+// - TopdownRecorder: measures benchmarks, and keeps their breakdown for
+//   `HtmlGraphRenderer::topdown()`.
+
+#ifndef topdown_counters_hpp
+#define topdown_counters_hpp
+
+#include "nanobench_html_graph_renderer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if __has_include(<linux/perf_event.h>) && __has_include(<sys/syscall.h>)
+#  include <linux/perf_event.h>
+#  include <sys/ioctl.h>
+#  include <sys/syscall.h>
+#  include <unistd.h>
+#  define NANOBENCH_VIOLIN_HAS_PERF_EVENT
+#endif
+
+/**
+ * Top-down and cache miss counters of the calling thread.
+ *
+ * The top-down events are read from the definitions the kernel exposes
+ * in `/sys/bus/event_source/devices/cpu/events/` -- `cpu_core` on
+ * hybrid CPUs:
+ * - with the perf metrics of Intel Ice Lake and later cores, level 1
+ *   comes from `slots` and `topdown-retiring`, `-bad-spec`, `-fe-bound`,
+ *   and `-be-bound`; level 2 is available when `topdown-heavy-ops`,
+ *   `-br-mispredict`, `-fetch-lat`, and `-mem-bound` also are -- e.g.
+ *   Sapphire Rapids;
+ * - on older Intel cores, only level 1 is available, from
+ *   `topdown-total-slots`, `-slots-issued`, `-slots-retired`,
+ *   `-fetch-bubbles`, and `-recovery-bubbles`.
+ * The L1D and LLC read misses are generic cache events, in their own
+ * group.
+ *
+ * Only user space is counted, which works with the default
+ * `perf_event_paranoid` of 2. What cannot be opened -- no PMU in a VM,
+ * AMD cores without top-down events... -- is simply unavailable.
+ *
+ * Counters are attached to the thread that constructs the instance,
+ * not to the threads it creates.
+ */
+class TopdownCounters
+{
+public:
+    /**
+     * Opens the counters, disabled.
+     * @throw std::bad_alloc if memory is exhausted. Unlikely.
+     */
+    TopdownCounters()
+    {
+#if defined(NANOBENCH_VIOLIN_HAS_PERF_EVENT)
+        std::string const pmu = core_pmu();
+        if (!pmu.empty()) {
+            if (open_events(m_topdown, pmu, {"slots", "topdown-retiring", "topdown-bad-spec", "topdown-fe-bound",
+                        "topdown-be-bound", "topdown-heavy-ops", "topdown-br-mispredict", "topdown-fetch-lat",
+                        "topdown-mem-bound"})) {
+                m_kind = kind::metrics_level2;
+            } else if (open_events(m_topdown, pmu, {"slots", "topdown-retiring", "topdown-bad-spec",
+                               "topdown-fe-bound", "topdown-be-bound"})) {
+                m_kind = kind::metrics_level1;
+            } else if (open_events(m_topdown, pmu, {"topdown-total-slots", "topdown-slots-issued",
+                               "topdown-slots-retired", "topdown-fetch-bubbles", "topdown-recovery-bubbles"})) {
+                m_kind = kind::legacy_level1;
+            }
+        }
+        auto const cache_miss = [](std::uint64_t cache) {
+            perf_event_attr attr{};
+            attr.type   = PERF_TYPE_HW_CACHE;
+            attr.config = cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+            return attr;
+        };
+        if (m_cache.add(cache_miss(PERF_COUNT_HW_CACHE_L1D))) m_l1d = int(m_cache.fds.size()) - 1;
+        if (m_cache.add(cache_miss(PERF_COUNT_HW_CACHE_LL))) m_llc = int(m_cache.fds.size()) - 1;
+#endif
+    }
+
+    /** Top-down level available: 0 when none, 1, or 2. */
+    [[nodiscard]]
+    int level() const noexcept
+    {
+        switch (m_kind) {
+            case kind::none:           return 0;
+            case kind::metrics_level2: return 2;
+            default:                   return 1;
+        }
+    }
+
+    [[nodiscard]] bool has_cache_misses() const noexcept { return m_l1d >= 0 || m_llc >= 0; }
+
+    /** Resets and enables the counters. */
+    void start() noexcept
+    {
+        m_topdown.start();
+        m_cache.start();
+    }
+
+    /** Disables the counters. */
+    void stop() noexcept
+    {
+        m_topdown.stop();
+        m_cache.stop();
+    }
+
+    /**
+     * Breakdown of what has been counted between `start()` and `stop()`.
+     * @param[in] units  Number of units processed, e.g. the number of
+     *                   calls times the batch size, to express the
+     *                   cache misses per unit.
+     * @return Empty `slots` when top-down isn't available, NaN misses
+     *         when they aren't.
+     * @throw std::bad_alloc if memory is exhausted. Unlikely.
+     */
+    [[nodiscard]]
+    topdown_breakdown read(double units) const
+    {
+        topdown_breakdown res;
+        std::vector<double> const v = m_topdown.read();
+        if (!v.empty()) {
+            switch (m_kind) {
+                case kind::metrics_level1:
+                case kind::metrics_level2: read_metrics(v, res); break;
+                case kind::legacy_level1:  read_legacy(v, res); break;
+                case kind::none:           break;
+            }
+        }
+        std::vector<double> const misses = m_cache.read();
+        if (!misses.empty() && units > 0) {
+            if (m_l1d >= 0) res.l1d_misses = misses[std::size_t(m_l1d)] / units;
+            if (m_llc >= 0) res.llc_misses = misses[std::size_t(m_llc)] / units;
+        }
+        return res;
+    }
+
+private:
+    enum class kind
+    {
+        none,
+        metrics_level1, ///< Ice Lake and later perf metrics
+        metrics_level2, ///< Same, with the level 2 metrics
+        legacy_level1,  ///< Older cores, 4 slots per cycle
+    };
+
+    /** One perf_event group; the first event is the leader. */
+    struct group
+    {
+        std::vector<int>    fds;
+        std::vector<double> scales; ///< From the sysfs `.scale` files
+
+        group() = default;
+        group(group const&)            = delete;
+        group& operator=(group const&) = delete;
+        ~group() { close(); }
+
+        void close() noexcept
+        {
+#if defined(NANOBENCH_VIOLIN_HAS_PERF_EVENT)
+            for (int const fd : fds) ::close(fd);
+#endif
+            fds.clear();
+            scales.clear();
+        }
+
+#if defined(NANOBENCH_VIOLIN_HAS_PERF_EVENT)
+        bool add(perf_event_attr attr, double scale = 1)
+        {
+            attr.size           = sizeof(attr);
+            attr.disabled       = fds.empty() ? 1 : 0;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv     = 1;
+            attr.read_format    = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            int const fd = int(::syscall(
+                    __NR_perf_event_open, &attr, 0, -1, fds.empty() ? -1 : fds.front(), PERF_FLAG_FD_CLOEXEC));
+            if (fd < 0) return false;
+            fds.push_back(fd);
+            scales.push_back(scale);
+            return true;
+        }
+#endif
+
+        void start() noexcept
+        {
+#if defined(NANOBENCH_VIOLIN_HAS_PERF_EVENT)
+            if (fds.empty()) return;
+            ::ioctl(fds.front(), PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+            ::ioctl(fds.front(), PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+        }
+
+        void stop() noexcept
+        {
+#if defined(NANOBENCH_VIOLIN_HAS_PERF_EVENT)
+            if (!fds.empty()) ::ioctl(fds.front(), PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+#endif
+        }
+
+        /** Scaled values, extrapolated when multiplexed; empty if nothing ran. */
+        std::vector<double> read() const
+        {
+            std::vector<double> values;
+#if defined(NANOBENCH_VIOLIN_HAS_PERF_EVENT)
+            if (fds.empty()) return values;
+            // nr, time_enabled, time_running, values...
+            std::vector<std::uint64_t> buffer(3 + fds.size());
+            auto const bytes = ::read(fds.front(), buffer.data(), buffer.size() * sizeof(std::uint64_t));
+            if (bytes < ssize_t(buffer.size() * sizeof(std::uint64_t)) || buffer[2] == 0) return values;
+            double const multiplexing = double(buffer[1]) / double(buffer[2]);
+            for (std::size_t i = 0; i < fds.size(); ++i) {
+                values.push_back(double(buffer[3 + i]) * scales[i] * multiplexing);
+            }
+#endif
+            return values;
+        }
+    };
+
+    static std::string read_line(std::string const& filename)
+    {
+        std::ifstream in(filename);
+        std::string   line;
+        std::getline(in, line);
+        return line;
+    }
+
+    /** sysfs directory of the PMU of the (performance) cores. */
+    static std::string core_pmu()
+    {
+        for (char const* name : {"cpu", "cpu_core"}) {
+            std::string const dir = std::string("/sys/bus/event_source/devices/") + name + "/";
+            if (!read_line(dir + "type").empty()) return dir;
+        }
+        return "";
+    }
+
+#if defined(NANOBENCH_VIOLIN_HAS_PERF_EVENT)
+    /**
+     * Translates the sysfs definition of `event`, e.g.
+     * "event=0x00,umask=0x81", with the `format/` of the PMU, e.g.
+     * "config:0-7".
+     * @return false if the event or one of its terms is unknown.
+     */
+    static bool sysfs_event(std::string const& pmu, std::string const& event, perf_event_attr& attr, double& scale)
+    {
+        std::string const definition = read_line(pmu + "events/" + event);
+        std::string const type       = read_line(pmu + "type");
+        if (definition.empty() || type.empty()) return false;
+        attr      = perf_event_attr{};
+        attr.type = std::uint32_t(std::stoul(type));
+        try {
+            std::stringstream terms(definition);
+            std::string       term;
+            while (std::getline(terms, term, ',')) {
+                auto const        eq    = term.find('=');
+                std::string const key   = term.substr(0, eq);
+                std::uint64_t     value = eq == std::string::npos ? 1 : std::stoull(term.substr(eq + 1), nullptr, 0);
+                std::string const fmt   = read_line(pmu + "format/" + key);
+                auto const        colon = fmt.find(':');
+                if (colon == std::string::npos) return false;
+                std::string const field  = fmt.substr(0, colon);
+                __u64* const      target = field == "config"  ? &attr.config
+                                         : field == "config1" ? &attr.config1
+                                         : field == "config2" ? &attr.config2
+                                                              : nullptr;
+                if (!target) return false;
+                // Bits of the value spread over the listed ranges, low bits first
+                std::stringstream ranges(fmt.substr(colon + 1));
+                std::string       range;
+                while (std::getline(ranges, range, ',')) {
+                    auto const dash  = range.find('-');
+                    int const  first = std::stoi(range.substr(0, dash));
+                    int const  last  = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+                    for (int bit = first; bit <= last; ++bit, value >>= 1) {
+                        if (value & 1) *target |= __u64(1) << bit;
+                    }
+                }
+            }
+            std::string const s = read_line(pmu + "events/" + event + ".scale");
+            scale = s.empty() ? 1 : std::stod(s);
+        } catch (std::exception const&) {
+            return false;
+        }
+        return true;
+    }
+
+    /** Opens all of `events` as one group, or none of them. */
+    static bool open_events(group& g, std::string const& pmu, std::vector<char const*> const& events)
+    {
+        for (char const* event : events) {
+            perf_event_attr attr;
+            double          scale = 1;
+            if (!sysfs_event(pmu, event, attr, scale) || !g.add(attr, scale)) {
+                g.close();
+                return false;
+            }
+        }
+        return true;
+    }
+#endif
+
+    void read_metrics(std::vector<double> const& v, topdown_breakdown& res) const
+    {
+        // The kernel turns each metric into a number of slots
+        double const total = v[1] + v[2] + v[3] + v[4];
+        if (!(total > 0)) return;
+        auto const part = [total](double x) { return std::max(0.0, x / total); };
+        if (m_kind == kind::metrics_level2) {
+            res.slots = {
+                {"retiring: heavy operations", part(v[5]), "#2ca02c"},
+                {"retiring: light operations", part(v[1] - v[5]), "#98df8a"},
+                {"bad speculation: branch mispredicts", part(v[6]), "#d62728"},
+                {"bad speculation: machine clears", part(v[2] - v[6]), "#ff9896"},
+                {"frontend: fetch latency", part(v[7]), "#9467bd"},
+                {"frontend: fetch bandwidth", part(v[3] - v[7]), "#c5b0d5"},
+                {"backend: memory bound", part(v[8]), "#1f77b4"},
+                {"backend: core bound", part(v[4] - v[8]), "#aec7e8"},
+            };
+        } else {
+            res.slots = level1(part(v[1]), part(v[2]), part(v[3]));
+        }
+    }
+
+    static void read_legacy(std::vector<double> const& v, topdown_breakdown& res)
+    {
+        // total slots, issued, retired, fetch bubbles, recovery bubbles
+        if (!(v[0] > 0)) return;
+        double const retiring = std::max(0.0, v[2] / v[0]);
+        double const bad      = std::max(0.0, (v[1] - v[2] + v[4]) / v[0]);
+        double const frontend = std::max(0.0, v[3] / v[0]);
+        res.slots = level1(retiring, bad, frontend);
+    }
+
+    /** Level 1, the backend bound being what remains. */
+    static std::vector<topdown_breakdown::Component> level1(double retiring, double bad, double frontend)
+    {
+        return {
+            {"retiring", retiring, "#2ca02c"},
+            {"bad speculation", bad, "#d62728"},
+            {"frontend bound", frontend, "#9467bd"},
+            {"backend bound", std::max(0.0, 1 - retiring - bad - frontend), "#1f77b4"},
+        };
+    }
+
+    group m_topdown;
+    group m_cache;
+    kind  m_kind = kind::none;
+    int   m_l1d  = -1; ///< Index in m_cache, -1 if not counted
+    int   m_llc  = -1;
+};
+
+/**
+ * Measures the top-down breakdown of benchmarks, and keeps it for the
+ * renderer:
+ *
+ * ```c++
+ * TopdownRecorder topdown;
+ * auto renderer = HtmlGraphRenderer("violin").topdown(
+ *         [&](std::string const& title, auto const& r) { return topdown.find(title, r); });
+ * ...
+ * topdown.run(bench, "name", [&]() { ... });
+ * ```
+ *
+ * nanobench has no hook between its epochs: the counters cover the
+ * whole `Bench::run()`, warmup included, and the cache misses are
+ * averaged over all the calls. Results are identified by their
+ * benchmark title, their name, and the `keys` context variables.
+ */
+class TopdownRecorder
+{
+public:
+    /**
+     * Constructor.
+     * @param[in] keys  Context variables that distinguish results with
+     *                  the same title and name.
+     * @throw std::bad_alloc if memory is exhausted.
+     */
+    explicit TopdownRecorder(std::vector<std::string> keys = {"cache"})
+    : m_keys(std::move(keys))
+    {}
+
+    /**
+     * Measures whatever `runner` does with `op`, typically running it
+     * in `bench`, and records it for the last result of `bench`.
+     * @tparam Runner  Callable taking the callable to benchmark, that
+     *                 counts its calls.
+     * @throw Whatever `runner` may throw.
+     * @note The counters are opened in the calling thread: the
+     *       function can be called from several threads.
+     */
+    template <typename Op, typename Runner>
+    void measure(ankerl::nanobench::Bench& bench, Op&& op, Runner&& runner)
+    {
+        TopdownCounters counters;
+        std::uint64_t   calls   = 0;
+        auto            counted = [&op, &calls]() {
+            ++calls;
+            op();
+        };
+        std::size_t const before = bench.results().size();
+        counters.start();
+        runner(counted);
+        counters.stop();
+        if (bench.results().size() == before) return;
+
+        // Each call processes batch() units, as for the per-unit plots
+        auto const&       r   = bench.results().back();
+        topdown_breakdown res = counters.read(double(calls) * r.config().mBatch);
+        if (res.slots.empty() && !std::isfinite(res.l1d_misses) && !std::isfinite(res.llc_misses)) return;
+        std::lock_guard   lock(m_mutex);
+        m_results[key(bench.title(), r)] = std::move(res);
+    }
+
+    /**
+     * Runs `op` in `bench`, and records its breakdown.
+     * @throw Whatever `Bench::run()` may throw.
+     */
+    template <typename Op>
+    void run(ankerl::nanobench::Bench& bench, std::string const& name, Op&& op)
+    {
+        measure(bench, std::forward<Op>(op), [&](auto& counted) { bench.run(name, counted); });
+    }
+
+    /**
+     * Breakdown of `r`, a result of the benchmark titled `title`.
+     * @return nullptr if it hasn't been measured.
+     */
+    [[nodiscard]]
+    topdown_breakdown const* find(std::string const& title, ankerl::nanobench::Result const& r) const
+    {
+        std::string const k = key(title, r);
+        std::lock_guard   lock(m_mutex);
+        auto const        it = m_results.find(k);
+        return it != m_results.end() ? &it->second : nullptr;
+    }
+
+private:
+    std::string key(std::string const& title, ankerl::nanobench::Result const& r) const
+    {
+        std::string k = title + '\n' + r.config().mBenchmarkName;
+        for (auto const& name : m_keys) {
+            std::string value;
+            try {
+                value = r.context(name);
+            } catch (std::exception const&) {
+                // Variable not set for this result
+            }
+            k += '\n' + value;
+        }
+        return k;
+    }
+
+    std::vector<std::string>                 m_keys;
+    std::map<std::string, topdown_breakdown> m_results;
+    mutable std::mutex                       m_mutex;
+};
+
+#endif // topdown_counters_hpp
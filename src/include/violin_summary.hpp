@@ -0,0 +1,154 @@
+// Quartiles, whiskers and kernel density estimates of benchmark samples.
+// ======================================================================
+// Copyright (c) 2025 CS GROUP
+//
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// ======================================================================
+//
+// Authors:
+// - Luc Hermitte, initial author
+//
+// Defines:
+// - violin_summary: quartiles, whiskers, and density of a series.
+// - summarize_violin(): computes a violin_summary of fixed resolution.
+
+#ifndef violin_summary_hpp
+#define violin_summary_hpp
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <numbers>
+#include <span>
+#include <vector>
+
+/**
+ * What a violin plot draws of a series, whatever its number of samples.
+ */
+struct violin_summary
+{
+    double min           = std::numeric_limits<double>::quiet_NaN();
+    double q1            = std::numeric_limits<double>::quiet_NaN();
+    double median        = std::numeric_limits<double>::quiet_NaN();
+    double q3            = std::numeric_limits<double>::quiet_NaN();
+    double max           = std::numeric_limits<double>::quiet_NaN();
+    /** Extreme samples within 1.5 interquartile range of the box. */
+    double lower_whisker = std::numeric_limits<double>::quiet_NaN();
+    double upper_whisker = std::numeric_limits<double>::quiet_NaN();
+    double mean          = std::numeric_limits<double>::quiet_NaN();
+    /** Kernel bandwidth. */
+    double bandwidth     = std::numeric_limits<double>::quiet_NaN();
+    /** Regular grid of values, and the estimated density at each. */
+    std::vector<double> y;
+    std::vector<double> density;
+};
+
+/**
+ * Quartiles, whiskers, and gaussian kernel density estimate of `x`.
+ *
+ * The bandwidth follows Silverman's rule of thumb, as plotly does, and
+ * the density is evaluated on `resolution` points from 2 bandwidths
+ * below the minimum to 2 bandwidths above the maximum -- plotly "soft"
+ * span. The samples are first linearly binned on the grid, so that the
+ * cost of the estimate is `O(n + resolution * kernel width)` instead of
+ * `O(n * resolution)`.
+ * @param[in] resolution  Number of points of the density, at least 2.
+ * @return An empty summary -- NaN and no density -- if `x` is empty.
+ * @throw std::bad_alloc if memory is exhausted.
+ */
+inline violin_summary summarize_violin(std::span<double const> x, std::size_t resolution = 100)
+{
+    violin_summary res;
+    if (x.empty()) return res;
+    resolution = std::max<std::size_t>(resolution, 2);
+
+    std::vector<double> v(x.begin(), x.end());
+    std::sort(v.begin(), v.end());
+    std::size_t const n        = v.size();
+    auto const        quantile = [&v, n](double p) {
+        double const      pos = p * double(n - 1);
+        std::size_t const i   = std::size_t(pos);
+        return i + 1 < n ? v[i] + (pos - double(i)) * (v[i + 1] - v[i]) : v[i];
+    };
+    res.min    = v.front();
+    res.max    = v.back();
+    res.q1     = quantile(0.25);
+    res.median = quantile(0.5);
+    res.q3     = quantile(0.75);
+    double const iqr = res.q3 - res.q1;
+    res.lower_whisker = *std::lower_bound(v.begin(), v.end(), res.q1 - 1.5 * iqr);
+    res.upper_whisker = *std::prev(std::upper_bound(v.begin(), v.end(), res.q3 + 1.5 * iqr));
+
+    double sum = 0;
+    for (auto const s : v) sum += s;
+    res.mean = sum / double(n);
+    double squares = 0;
+    for (auto const s : v) squares += (s - res.mean) * (s - res.mean);
+    double const sd = n > 1 ? std::sqrt(squares / double(n - 1)) : 0;
+
+    double spread = iqr > 0 ? std::min(sd, iqr / 1.349) : sd;
+    // Constant series: a narrow spike rather than a division by 0
+    if (!(spread > 0)) spread = std::max(std::abs(res.median) * 1e-3, std::numeric_limits<double>::min());
+    res.bandwidth = 1.059 * spread * std::pow(double(n), -0.2);
+
+    double const lo    = res.min - 2 * res.bandwidth;
+    double const delta = (res.max - lo + 2 * res.bandwidth) / double(resolution - 1);
+    res.y.resize(resolution);
+    for (std::size_t i = 0; i < resolution; ++i) res.y[i] = lo + double(i) * delta;
+
+    // Kernel weights per grid offset, up to 5 bandwidths away, and bins
+    // padded by this width on both sides
+    std::size_t const   width = std::min(resolution, std::size_t(5 * res.bandwidth / delta) + 1);
+    std::vector<double> kernel(width);
+    for (std::size_t d = 0; d < width; ++d) {
+        double const u = double(d) * delta / res.bandwidth;
+        kernel[d]      = std::exp(-0.5 * u * u);
+    }
+    std::vector<double> bins(resolution + 2 * width, 0.0);
+    for (auto const s : v) {
+        double const      pos  = (s - lo) / delta;
+        std::size_t const i    = std::min(std::size_t(pos), resolution - 2);
+        double const      frac = pos - double(i);
+        bins[width + i] += 1 - frac;
+        bins[width + i + 1] += frac;
+    }
+
+    // Convolution, one kernel weight at a time: the inner loops are
+    // plain vector multiply-adds
+    res.density.assign(resolution, 0.0);
+    double* const       density = res.density.data();
+    double const* const centre  = bins.data() + width;
+    for (std::size_t i = 0; i < resolution; ++i) density[i] = kernel[0] * centre[i];
+    for (std::size_t d = 1; d < width; ++d) {
+        double const        w     = kernel[d];
+        double const* const below = centre - d;
+        double const* const above = centre + d;
+        for (std::size_t i = 0; i < resolution; ++i) density[i] += w * (below[i] + above[i]);
+    }
+    double const norm = 1 / (double(n) * res.bandwidth * std::sqrt(2 * std::numbers::pi));
+    for (auto& d : res.density) d *= norm;
+    return res;
+}
+
+#endif // violin_summary_hpp
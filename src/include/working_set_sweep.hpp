@@ -0,0 +1,178 @@
+// Working-set sweeps across the cache hierarchy.
+// ======================================================================
+// Copyright (c) 2025 CS GROUP
+//
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// ======================================================================
+//
+// Authors:
+// - Luc Hermitte, initial author
+//
+// ======================================================================
+//
+// Defines:
+// - geometric_sizes(): geometric series of working-set sizes.
+// - WorkingSetSweep: runs a kernel over working-set sizes that cross
+//   every cache level, and describes the resulting LinePlot.
+
+#ifndef working_set_sweep_hpp
+#define working_set_sweep_hpp
+
+#include "cache_topology.hpp"
+#include "nanobench_html_graph_renderer.hpp"
+#include "test_vector.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * Geometric series of sizes from `first` to `last` -- included.
+ * Sizes are rounded to multiples of `granularity`, and duplicates are
+ * removed.
+ * @param[in] first              Smallest size, in bytes.
+ * @param[in] last               Biggest size, in bytes.
+ * @param[in] points_per_octave  Number of sizes each time the size
+ *                               doubles.
+ * @param[in] granularity        Rounding, typically a cache line.
+ * @throw std::bad_alloc if memory is exhausted.
+ * @pre `0 < first <= last`, `points_per_octave > 0`, `granularity > 0`
+ */
+inline std::vector<std::size_t> geometric_sizes(
+        std::size_t first, std::size_t last, unsigned points_per_octave = 2,
+        std::size_t granularity = 64)
+{
+    std::vector<std::size_t> sizes;
+    double const             ratio = std::exp2(1.0 / points_per_octave);
+    for (double s = double(first); s <= double(last) * 1.0001; s *= ratio) {
+        auto const multiple = std::size_t(std::llround(s / double(granularity)));
+        auto const rounded  = std::max(granularity, multiple * granularity);
+        if (sizes.empty() || sizes.back() != rounded) sizes.push_back(rounded);
+    }
+    return sizes;
+}
+
+/**
+ * Runs kernels over a series of working-set sizes that crosses each
+ * cache level, up to DRAM.
+ *
+ * By default, the sizes go from 1/8 of L1 to 4 times the last level
+ * cache, with 2 points per octave. Each kernel produces a series of
+ * `Bench` results, one per size, that `plot()` describes as a log-x
+ * line plot of the throughputs, where the cache boundaries are marked.
+ *
+ * ```c++
+ * WorkingSetSweep sweep;
+ * sweep.run(bench, "copy", [](ankerl::nanobench::Bench& b, std::size_t bytes) {
+ *     ... allocate data ...
+ *     b.batch(number_of_elements);
+ *     return [=]() mutable { ... kernel ... };
+ * });
+ * render_line_graph(bench, sweep.plot(), "copy-sweep");
+ * ```
+ */
+class WorkingSetSweep
+{
+public:
+    /**
+     * Constructs a sweep with the default sizes for `topology`.
+     * @throw std::bad_alloc if memory is exhausted.
+     */
+    explicit WorkingSetSweep(
+            CacheTopology topology = CacheTopology::detect(), unsigned points_per_octave = 2)
+    : m_topology(std::move(topology))
+    {
+        std::size_t const l1  = m_topology.size_or_default(1);
+        std::size_t const llc = m_topology.last_level_size_or_default();
+        m_sizes = geometric_sizes(l1 / 8, llc * 4, points_per_octave, m_topology.line_size());
+        init_plot();
+    }
+
+    /**
+     * Constructs a sweep over explicit sizes.
+     * @throw std::bad_alloc if memory is exhausted.
+     */
+    WorkingSetSweep(CacheTopology topology, std::vector<std::size_t> sizes)
+    : m_topology(std::move(topology))
+    , m_sizes(std::move(sizes))
+    {
+        init_plot();
+    }
+
+    /**
+     * Benchmarks one kernel for every working-set size.
+     *
+     * @tparam Setup  Callable taking `(ankerl::nanobench::Bench&, std::size_t bytes)`
+     *                and returning the nullary callable to benchmark.
+     * @param[in,out] bench   Benchmark object where results are appended.
+     * @param[in]     series  Name of the kernel; the size is appended to
+     *                        it for each individual result.
+     * @param[in]     setup   Prepares a working set of `bytes` bytes.
+     *                        It may also adjust `bench` options like
+     *                        `batch()`.
+     * @return *this
+     * @throw Whatever `setup` or `Bench::run()` may throw.
+     */
+    template <typename Setup>
+    WorkingSetSweep& run(ankerl::nanobench::Bench& bench, std::string const& series, Setup&& setup)
+    {
+        LinePlot::Series s;
+        s.name = series;
+        for (auto const bytes : m_sizes) {
+            auto op = setup(bench, bytes);
+            record_pages(bench);
+            s.results.push_back(bench.results().size());
+            s.x.push_back(double(bytes));
+            bench.run(series + " " + human_bytes(bytes), op);
+        }
+        m_plot.series.push_back(std::move(s));
+        return *this;
+    }
+
+    [[nodiscard]] std::vector<std::size_t> const& sizes() const noexcept { return m_sizes; }
+    [[nodiscard]] CacheTopology const& topology() const noexcept { return m_topology; }
+
+    /** Plot description of all the kernels run so far. */
+    [[nodiscard]] LinePlot const& plot() const noexcept { return m_plot; }
+
+private:
+    void init_plot()
+    {
+        m_plot.x_title    = "working set (bytes)";
+        m_plot.throughput = true;
+        for (auto const& l : m_topology.levels()) {
+            std::string label = "L";
+            label.append(std::to_string(l.number)).append(" ").append(human_bytes(l.size));
+            m_plot.markers.push_back({double(l.size), std::move(label)});
+        }
+    }
+
+    CacheTopology            m_topology;
+    std::vector<std::size_t> m_sizes;
+    LinePlot                 m_plot;
+};
+
+#endif // working_set_sweep_hpp
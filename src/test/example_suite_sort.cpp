@@ -0,0 +1,61 @@
+// Sorting test cases of example_suite
+// ======================================================================
+// Copyright (c) 2025 CS GROUP
+//
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// ======================================================================
+//
+// Authors:
+// - Luc Hermitte, initial author
+//
+// ======================================================================
+
+#include "nanobench_violin_pch.hpp"
+#include <algorithm>
+
+template <typename T>
+void bench_sort(ankerl::nanobench::Bench& bench, char const* name, std::size_t const count)
+{
+    auto const     x = datasets().get<T>(count, 1, 1'000'000, 2);
+    test_vector<T> y(count);
+    bench.batch(count);
+    record_pages(bench);
+    run_adaptive(bench, name, [&]() {
+            std::copy(x.begin(), x.end(), y.begin());
+            std::sort(y.begin(), y.end());
+            ankerl::nanobench::doNotOptimizeAway(y.data());
+            });
+}
+
+TEST_CASE("sort")
+{
+    auto bench = ankerl::nanobench::Bench()
+        .title("sort")
+        .unit("element")
+        .warmup(10)
+        .minEpochIterations(100)
+        .relative(true);
+    bench_sort<int>(bench, "int", 1024);
+    bench_sort<double>(bench, "double", 1024);
+    render_graph(bench, "sort");
+}
@@ -0,0 +1,59 @@
+// Summation test cases of example_suite
+// ======================================================================
+// Copyright (c) 2025 CS GROUP
+//
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// ======================================================================
+//
+// Authors:
+// - Luc Hermitte, initial author
+//
+// ======================================================================
+
+#include "nanobench_violin_pch.hpp"
+#include <numeric>
+
+template <typename T>
+void bench_sum(ankerl::nanobench::Bench& bench, char const* name, std::size_t const count)
+{
+    auto const x = datasets().get<T>(count, 1, 1'000, 1);
+    bench.batch(count * sizeof(T));
+    record_pages(bench);
+    run_adaptive(bench, name, [&]() {
+            auto const s = std::accumulate(x.begin(), x.end(), T{});
+            ankerl::nanobench::doNotOptimizeAway(s);
+            });
+}
+
+TEST_CASE("sum")
+{
+    auto bench = ankerl::nanobench::Bench()
+        .title("sum")
+        .unit("B")
+        .warmup(100)
+        .minEpochIterations(1'000)
+        .relative(true);
+    bench_sum<float>(bench, "float", 4096);
+    bench_sum<double>(bench, "double", 4096);
+    render_graph(bench, "sum");
+}
@@ -32,106 +32,319 @@
 
 #define NANOBENCH_VIOLIN_OPTIONS \
     .showepochs(true) \
-    .rangemode("")
+    .timeseries(true) \
+    .rangemode("") \
+    .metrics({Metric::elapsed, Metric::throughput, Metric::ipc, Metric::cycles_per_unit}) \
+    .peakbandwidth(BandwidthReference::load().peak(), "DRAM peak") \
+    .groupby("cache")
 
+#include "bandwidth_reference.hpp"
 #include "nanobench_html_graph_doctest_main.hpp"
-#include "rng.hpp"
+#include "bench_matrix.hpp"
+#include "cold_cache.hpp"
+#include "dataset_cache.hpp"
+#include "isa_dispatch.hpp"
+#include "pointer_chase.hpp"
+#include "test_vector.hpp"
+#include "thread_scaling.hpp"
+#include "working_set_sweep.hpp"
+#include <span>
 #include <vector>
 
-#if __has_include(<boost/align/aligned_allocator.hpp>)
-#  include <boost/align/aligned_allocator.hpp>
-
-#  if defined(LEVEL1_DCACHE_LINESIZE)
-constexpr std::size_t hardware_constructive_interference_size = LEVEL1_DCACHE_LINESIZE;
-#  elif defined(__cpp_lib_hardware_interference_size)
-constexpr std::size_t hardware_constructive_interference_size =
-        std::hardware_constructive_interference_size;
-#  else
-constexpr std::size_t hardware_constructive_interference_size = 64;
-#  endif
-
-template <typename T, std::size_t alignment = hardware_constructive_interference_size>
-using test_vector = std::vector<T, boost::alignment::aligned_allocator<T, alignment>>;
-
-#else
-template <typename T>
-using test_vector = std::vector<T>;
-#endif
-
-constexpr auto avail_L1 = LEVEL1_DCACHE_SIZE / 8;
-constexpr auto avail_L2 = LEVEL2_DCACHE_SIZE / 8;
+// Detected at runtime: the binary stays correct on another host
+CacheTopology const topology = CacheTopology::detect();
+std::size_t const   avail_L1 = topology.size_or_default(1) / 8;
+std::size_t const   avail_L2 = topology.size_or_default(2) / 8;
 
 template <typename T, typename  Func>
-void compute(test_vector<T> const& a, test_vector<T> const& b, test_vector<T>& out, Func op)
+void compute(std::span<T const> a, std::span<T const> b, std::span<T> out, Func op)
 {
     for (std::size_t i = 0; i < a.size(); ++i) {
         out[i] = op(a[i], b[i]);
     }
 }
 
+// Arithmetic on special values may take microcode assists, that
+// uniform inputs never trigger
+enum class DataShape { uniform, denormals, nans };
+
+char const* data_shape_name(DataShape shape)
+{
+    switch (shape) {
+        case DataShape::uniform:   return "uniform";
+        case DataShape::denormals: return "1% denormals";
+        case DataShape::nans:      return "1% NaNs";
+    }
+    return "?";
+}
+
+// Inputs are shared between all the benchmarks through the dataset
+// cache: they are generated only once per process.
 template <typename T>
-test_vector<T> random_vector(int count)
+std::span<T const> random_vector(
+        std::size_t count, std::uint64_t seed, DataShape shape = DataShape::uniform)
 {
-    test_vector<T> v;
-    v.reserve(count);
-  for (auto i : RNG<T>(1, 1'000'000, count)) {
-      v.push_back(i);
-  }
-  return v;
+    switch (shape) {
+        case DataShape::denormals:
+            return datasets().get(count, special_values_mapping<T>(1, 1'000'000, 0.01, 0), seed);
+        case DataShape::nans:
+            return datasets().get(count, special_values_mapping<T>(1, 1'000'000, 0, 0.01), seed);
+        case DataShape::uniform:
+            break;
+    }
+    return datasets().get<T>(count, 1, 1'000'000, seed);
 }
 
+// In cold mode, each call works on its own copy of x, y, and z, that
+// has been evicted from the caches by the other copies.
+// The number of epochs depends on the noise: see --target-error.
 template <typename T, typename Func>
-void bench_arite2(ankerl::nanobench::Bench& bench, char const* name, int const bytes, Func op)
+void bench_arite2(
+        ankerl::nanobench::Bench& bench, char const* name, std::size_t const bytes, Func op,
+        CacheState cache = CacheState::warm, DataShape shape = DataShape::uniform)
 {
-  int const count = bytes / sizeof(T);
-  auto const x = random_vector<T>(count);
-  auto const y = random_vector<T>(count);
-  test_vector<T> z(count);
-
-  bench.run(name, [&]() {
-          op(x, y, z);
-          ankerl::nanobench::doNotOptimizeAway(z);
+  std::size_t const count = bytes / sizeof(T);
+  auto const x = random_vector<T>(count, 1, shape);
+  auto const y = random_vector<T>(count, 2, shape);
+
+  // Traffic per iteration: x and y are read, z is written
+  bench.batch(3 * count * sizeof(T));
+  bench.context("cache", cache_state_name(cache));
+  if (cache == CacheState::warm) {
+      test_vector<T> z(count);
+      record_pages(bench);
+      run_adaptive(bench, name, [&]() {
+              op(x, y, std::span<T>(z));
+              ankerl::nanobench::doNotOptimizeAway(z);
+              });
+      return;
+  }
+
+  std::size_t const copies = ColdRing<T>::copies_for(3 * count * sizeof(T), topology);
+  ColdRing<T> xs(x, copies), ys(y, copies), zs(count, copies);
+  record_pages(bench);
+  run_adaptive(bench, name, [&]() {
+          auto const z = zs.next();
+          op(xs.next(), ys.next(), z);
+          ankerl::nanobench::doNotOptimizeAway(z.data());
           });
 }
 
-TEST_CASE("mult/div float L1")
+TEST_CASE("mult/div L1/L2")
+{
+    // One Bench per type, with "/ L1", "/ L2", "* L1", "* L2" results,
+    // as warm and cold pairs
+    BenchMatrix<type_list<float, double>, op_list<op_div, op_mul>> matrix(
+            "mult/div", {{"L1", avail_L1}, {"L2", avail_L2}});
+    matrix.configure([](ankerl::nanobench::Bench& b) {
+        b.unit("B")
+            .warmup(100)
+            .minEpochIterations(100'000)
+            .relative(true);
+        b.performanceCounters(true);
+    });
+    matrix.run(
+            []<typename T, typename Op>(
+                    ankerl::nanobench::Bench& b, std::string const& name, std::size_t bytes) {
+                for (auto const cache : {CacheState::warm, CacheState::cold}) {
+                    bench_arite2<T>(
+                            b, name.c_str(), bytes,
+                            [](std::span<T const> x, std::span<T const> y, std::span<T> out) {
+                                compute(x, y, out, Op{});
+                            },
+                            cache);
+                }
+            },
+            [](ankerl::nanobench::Bench const& b, std::string const& title) {
+                render_graph(b, title);
+            });
+}
+
+TEST_CASE("mult/div float data shapes")
 {
     ankerl::nanobench::Bench b;
-    b.title("mult/div float L1")
-        .unit("int")
+    b.title("mult/div float data shapes")
+        .unit("B")
         .warmup(100)
         .minEpochIterations(100'000)
-        .epochs(50)
         .relative(true);
     b.performanceCounters(true);
 
-    bench_arite2<float>(
-            b, "/ L1", avail_L1,
-            [](test_vector<float> const& a, test_vector<float> const& b, test_vector<float>& out) {
-                compute(a, b, out, [](auto l, auto r) { return l / r; });
-            }
-    );
-
-    bench_arite2<float>(
-            b, "/ L2", avail_L2,
-            [](test_vector<float> const& a, test_vector<float> const& b, test_vector<float>& out) {
-                compute(a, b, out, [](auto l, auto r) { return l / r; });
-            }
-    );
-
-    bench_arite2<float>(
-            b, "* L1", avail_L1,
-            [](test_vector<float> const& a, test_vector<float> const& b, test_vector<float>& out) {
-                compute(a, b, out, [](auto l, auto r) { return l * r; });
-            }
-    );
-
-    bench_arite2<float>(
-            b, "* L2", avail_L2,
-            [](test_vector<float> const& a, test_vector<float> const& b, test_vector<float>& out) {
-                compute(a, b, out, [](auto l, auto r) { return l * r; });
-            }
-    );
-
-    render_graph(b, "mult/div float L1");
+    for (auto const shape : {DataShape::uniform, DataShape::denormals, DataShape::nans}) {
+        std::string const suffix = std::string(" ") + data_shape_name(shape);
+        bench_arite2<float>(
+                b, ("/" + suffix).c_str(), avail_L1,
+                [](std::span<float const> x, std::span<float const> y, std::span<float> out) {
+                    compute(x, y, out, op_div{});
+                },
+                CacheState::warm, shape);
+        bench_arite2<float>(
+                b, ("*" + suffix).c_str(), avail_L1,
+                [](std::span<float const> x, std::span<float const> y, std::span<float> out) {
+                    compute(x, y, out, op_mul{});
+                },
+                CacheState::warm, shape);
+    }
+    render_graph(b, "mult/div float data shapes");
+}
+
+TEST_CASE("select taken ratios")
+{
+    ankerl::nanobench::Bench b;
+    b.title("select taken ratios")
+        .unit("element")
+        .warmup(10)
+        .minEpochIterations(1'000)
+        .relative(true);
+    b.performanceCounters(true);
+
+    // Same work for every ratio: only the predictability of the branch
+    // changes
+    std::size_t const          count = avail_L1;
+    test_vector<std::uint32_t> selected(count);
+    b.batch(count);
+    for (double const ratio : {1.0, 0.99, 0.9, 0.5}) {
+        auto const taken = datasets().get(count, bernoulli_mapping<std::uint8_t>(ratio), 1);
+        record_pages(b);
+        run_adaptive(b, "taken " + std::to_string(int(ratio * 100)) + "%", [&]() {
+                std::size_t n = 0;
+                for (std::size_t i = 0; i < count; ++i) {
+                    if (taken[i]) selected[n++] = std::uint32_t(i);
+                }
+                ankerl::nanobench::doNotOptimizeAway(n);
+                });
+    }
+    render_graph(b, "select taken ratios");
+}
+
+TEST_CASE("histogram key skew")
+{
+    ankerl::nanobench::Bench b;
+    b.title("histogram key skew")
+        .unit("key")
+        .warmup(10)
+        .minEpochIterations(100)
+        .relative(true);
+    b.performanceCounters(true);
+
+    // The counters don't fit in L2: uniform keys miss, while skewed keys
+    // hit a few hot counters whose increments depend on each other
+    std::size_t const          l2    = std::max<std::size_t>(topology.size(2), std::size_t(1) << 20);
+    auto const                 keys  = std::uint32_t(4 * l2 / sizeof(std::uint32_t));
+    std::size_t const          count = std::size_t(1) << 20;
+    test_vector<std::uint32_t> counters(keys);
+    b.batch(count);
+
+    auto const histogram = [&](std::string const& name, std::span<std::uint32_t const> input) {
+        record_pages(b);
+        run_adaptive(b, name, [&]() {
+                for (auto const k : input) ++counters[k];
+                ankerl::nanobench::doNotOptimizeAway(counters.data());
+                });
+    };
+    histogram("uniform", datasets().get<std::uint32_t>(count, 0, keys - 1, 1));
+    histogram("zipf 0.8", datasets().get(count, zipf_mapping<std::uint32_t>(keys, 0.8), 1));
+    histogram("zipf 1.1", datasets().get(count, zipf_mapping<std::uint32_t>(keys, 1.1), 1));
+    render_graph(b, "histogram key skew");
+}
+
+// Same loop as compute(), compiled for each ISA: raw pointers and no
+// functor, so that nothing prevents the auto-vectorization
+NANOBENCH_ISA_KERNEL(mul_float, (float const* x, float const* y, float* z, std::size_t n), {
+    for (std::size_t i = 0; i < n; ++i) {
+        z[i] = x[i] * y[i];
+    }
+})
+
+TEST_CASE("mult float ISA variants")
+{
+    ankerl::nanobench::Bench b;
+    b.title("mult float ISA variants")
+        .unit("B")
+        .warmup(100)
+        .minEpochIterations(100'000)
+        .epochs(50)
+        .relative(true);
+
+    // L1-resident: the kernel is compute-bound
+    std::size_t const count = avail_L1 / sizeof(float);
+    auto const x = random_vector<float>(count, 1);
+    auto const y = random_vector<float>(count, 2);
+    test_vector<float> z(count);
+
+    b.batch(3 * count * sizeof(float));
+    record_pages(b);
+    run_isa_variants(b, "*", mul_float, [&](auto kernel) {
+        kernel(x.data(), y.data(), z.data(), count);
+        ankerl::nanobench::doNotOptimizeAway(z);
+    });
+
+    render_graph(b, "mult float ISA variants");
+}
+
+TEST_CASE("mult float working set sweep")
+{
+    ankerl::nanobench::Bench b;
+    b.title("mult float working set sweep")
+        .unit("float")
+        .warmup(10)
+        .epochs(11);
+
+    WorkingSetSweep sweep(topology);
+    sweep.run(b, "*", [](ankerl::nanobench::Bench& bench, std::size_t bytes) {
+        // x, y and z share the working set
+        std::size_t const count = std::max<std::size_t>(1, bytes / (3 * sizeof(float)));
+        test_vector<float> x(count), y(count), z(count);
+        RNG<float>(rng_seed{1}, 1, 1'000'000, count).fill_parallel(x);
+        RNG<float>(rng_seed{2}, 1, 1'000'000, count).fill_parallel(y);
+        bench.batch(count);
+        return [x = std::move(x), y = std::move(y), z = std::move(z)]() mutable {
+            compute<float>(x, y, z, [](auto l, auto r) { return l * r; });
+            ankerl::nanobench::doNotOptimizeAway(z);
+        };
+    });
+
+    render_line_graph(b, sweep.plot(), "mult float working set sweep");
+}
+
+TEST_CASE("mult float thread scaling")
+{
+    ankerl::nanobench::Bench b;
+    b.title("mult float thread scaling")
+        .unit("float")
+        .warmup(10)
+        .epochs(11);
+
+    // Each thread has its own working set, twice as big as the last level
+    // cache: the kernel is memory-bound
+    std::size_t const llc   = std::max<std::size_t>(topology.last_level_size(), std::size_t(8) << 20);
+    std::size_t const count = 2 * llc / (3 * sizeof(float));
+
+    ThreadScaling scaling;
+    scaling.run(b, "*", count, [count](unsigned thread, unsigned) {
+        // Initialized from the pinned thread -- and not with
+        // fill_parallel(): pages are local to its NUMA node
+        test_vector<float> x(count), y(count), z(count);
+        RNG<float>(rng_seed{2 * thread + 1}, 1, 1'000'000, count).fill(x);
+        RNG<float>(rng_seed{2 * thread + 2}, 1, 1'000'000, count).fill(y);
+        return [x = std::move(x), y = std::move(y), z = std::move(z)]() mutable {
+            compute<float>(x, y, z, [](auto l, auto r) { return l * r; });
+            ankerl::nanobench::doNotOptimizeAway(z);
+        };
+    });
+
+    render_line_graph(b, scaling.plot(), "mult float thread scaling");
+}
+
+TEST_CASE("load latency")
+{
+    ankerl::nanobench::Bench b;
+    b.title("load latency")
+        .warmup(10)
+        .epochs(11);
+
+    LatencySweep latency(topology);
+    latency.run(b);
+
+    render_line_graph(b, latency.plot(b), "load latency");
 }
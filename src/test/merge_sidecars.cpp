@@ -0,0 +1,235 @@
+// Merges JSON Lines sidecars of several runs into one comparative report.
+// ======================================================================
+// Copyright (c) 2025 CS GROUP
+//
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// ======================================================================
+//
+// Authors:
+// - Luc Hermitte, initial author
+//
+// ======================================================================
+
+// Usage: merge_sidecars [-o report.html] [label=]run.jsonl...
+//
+// Runs are typically the same suite on several hosts, or built with
+// several compilers -- see `--jsonto=`. Benchmarks are aligned by title,
+// and results by name and "cache" context: each plot shows the violins
+// of every run side by side. A final table gives the speedup of the
+// median of each run over the first one.
+//
+// Inputs are read in lockstep, one benchmark at a time: memory stays
+// bounded whatever the number of runs and the size of the suite. This
+// requires the runs to list their benchmarks in the same order; a
+// benchmark missing from some runs is simply drawn without them.
+//
+// Runs are labelled "<host> / <compiler>" from their metadata, unless a
+// label is given on the command line.
+
+#include "nanobench_html_graph_renderer.hpp"
+#include "nanobench_sidecar.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace
+{
+struct run_input
+{
+    std::string                   label;
+    SidecarReader                 reader;
+    std::optional<sidecar_result> pending; ///< Next result, not merged yet
+
+    void advance()
+    {
+        sidecar_result r;
+        if (reader.next(r)) {
+            pending = std::move(r);
+        } else {
+            pending.reset();
+        }
+    }
+};
+
+/// Medians of one result, in every run.
+struct summary_row
+{
+    std::string         title;
+    std::string         result;
+    std::vector<double> medians;
+};
+
+double median(std::vector<double> v)
+{
+    std::erase_if(v, [](double x) { return !std::isfinite(x); });
+    if (v.empty()) return std::numeric_limits<double>::quiet_NaN();
+    std::sort(v.begin(), v.end());
+    return v.size() % 2 ? v[v.size() / 2] : (v[v.size() / 2 - 1] + v[v.size() / 2]) / 2;
+}
+
+/// Warm and cold results share their names.
+std::string result_key(sidecar_result const& r)
+{
+    auto const cache = r.context.find("cache");
+    return cache == r.context.end() ? r.name : r.name + " (" + cache->second + ")";
+}
+
+std::string html_escape(std::string const& s)
+{
+    std::string out;
+    for (char const c : s) {
+        switch (c) {
+            case '<': out += "&lt;"; break;
+            case '>': out += "&gt;"; break;
+            case '&': out += "&amp;"; break;
+            case '"': out += "&quot;"; break;
+            default:  out += c;
+        }
+    }
+    return out;
+}
+
+std::string format_speedup(double base, double value)
+{
+    if (!(base > 0) || !(value > 0)) return "-";
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.2fx", base / value);
+    return buffer;
+}
+
+int usage(char const* program)
+{
+    std::cerr << "Usage: " << program << " [-o report.html] [label=]run.jsonl...\n";
+    return EXIT_FAILURE;
+}
+} // anonymous namespace
+
+int main(int argc, char** argv)
+{
+    std::string                             output = "merged.html";
+    std::vector<std::unique_ptr<run_input>> runs;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string const arg = argv[i];
+            if (arg == "-o" && i + 1 < argc) {
+                output = argv[++i];
+                continue;
+            }
+            if (arg.starts_with("-")) return usage(argv[0]);
+            auto const  eq       = arg.find('=');
+            std::string filename = eq == std::string::npos ? arg : arg.substr(eq + 1);
+            auto        run      = std::make_unique<run_input>(
+                    run_input{eq == std::string::npos ? "" : arg.substr(0, eq), SidecarReader(filename), {}});
+            // Reads the metadata line on the way
+            run->advance();
+            if (run->label.empty()) {
+                auto const& meta  = run->reader.metadata();
+                auto const  host  = meta.find("host");
+                auto const  build = meta.find("compiler");
+                run->label = (host != meta.end() ? host->second : filename)
+                    + (build != meta.end() ? " / " + build->second : "");
+                for (auto const& other : runs) {
+                    if (other->label == run->label) run->label += " (" + filename + ")";
+                }
+            }
+            runs.push_back(std::move(run));
+        }
+        if (runs.empty()) return usage(argv[0]);
+
+        auto renderer = HtmlGraphRenderer("violin").showlegend(true).encoding(PayloadEncoding::float32);
+        renderer.open(output);
+
+        std::vector<summary_row>           rows;
+        std::map<std::string, std::size_t> row_of;
+        for (std::size_t plot_index = 0;; ++plot_index) {
+            // Next benchmark: the first one of the first run that has some left
+            auto const next = std::find_if(runs.begin(), runs.end(), [](auto const& r) { return r->pending.has_value(); });
+            if (next == runs.end()) break;
+            std::string const title = (*next)->pending->title;
+
+            ViolinPlot plot;
+            plot.title = title;
+            for (std::size_t i = 0; i < runs.size(); ++i) {
+                auto& run = *runs[i];
+                while (run.pending && run.pending->title == title) {
+                    std::string const key     = result_key(*run.pending);
+                    auto&             elapsed = run.pending->epochs["elapsed"];
+                    // Per iteration in the sidecars, drawn per unit
+                    for (auto& x : elapsed) x /= run.pending->batch;
+
+                    auto const [it, inserted] = row_of.emplace(title + '\n' + key, rows.size());
+                    if (inserted) {
+                        rows.push_back({title, key, std::vector<double>(runs.size(), std::numeric_limits<double>::quiet_NaN())});
+                    }
+                    rows[it->second].medians[i] = median(elapsed);
+                    plot.traces.push_back({key, run.label, std::move(elapsed)});
+                    run.advance();
+                }
+            }
+            // Group the traces by result, in the order of their first appearance
+            std::stable_sort(plot.traces.begin(), plot.traces.end(), [&](auto const& l, auto const& r) {
+                return row_of.at(title + '\n' + l.name) < row_of.at(title + '\n' + r.name);
+            });
+            renderer.render_violins_to(plot, "merged" + std::to_string(plot_index));
+        }
+
+        // Summary table, both in the report and on the console
+        auto& html = renderer.stream();
+        html << "    <h2>Median speedups over " << html_escape(runs.front()->label) << "</h2>\n"
+             << "    <table border=\"1\" style=\"border-collapse: collapse; font-family: sans-serif\">\n"
+             << "      <tr><th>benchmark</th><th>result</th>";
+        std::cout << "benchmark\tresult";
+        for (auto const& run : runs) {
+            html << "<th>" << html_escape(run->label) << "</th>";
+            std::cout << '\t' << run->label;
+        }
+        html << "</tr>\n";
+        std::cout << '\n';
+        for (auto const& row : rows) {
+            html << "      <tr><td>" << html_escape(row.title) << "</td><td>" << html_escape(row.result) << "</td>";
+            std::cout << row.title << '\t' << row.result;
+            for (double const m : row.medians) {
+                std::string const speedup = format_speedup(row.medians.front(), m);
+                html << "<td>" << speedup << "</td>";
+                std::cout << '\t' << speedup;
+            }
+            html << "</tr>\n";
+            std::cout << '\n';
+        }
+        html << "    </table>\n";
+        std::cerr << "[nanobench] " << runs.size() << " runs merged into " << output << "\n";
+    } catch (std::exception const& e) {
+        std::cerr << "[nanobench] " << e.what() << "\n";
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,167 @@
+// STREAM-like memory bandwidth reference suite
+// ======================================================================
+// Copyright (c) 2025 CS GROUP
+//
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// ======================================================================
+//
+// Authors:
+// - Luc Hermitte, initial author
+//
+// ======================================================================
+
+// Copy/scale/add/triad kernels, as defined by John McCalpin's STREAM
+// benchmark, run over working sets that fit in each cache level and in
+// DRAM, on 1 thread and on all the allowed cores.
+//
+// The best bandwidths are stored in the per-host file returned by
+// `BandwidthReference::default_path()`. Other reports load it to draw
+// the peak bandwidth on their throughput plots.
+
+#define NANOBENCH_VIOLIN_OPTIONS \
+    .rangemode("tozero") \
+    .metrics({Metric::throughput}) \
+    .peakbandwidth(BandwidthReference::load().peak(), "DRAM peak")
+
+#include "bandwidth_reference.hpp"
+#include "nanobench_html_graph_doctest_main.hpp"
+#include "cache_topology.hpp"
+#include "rng.hpp"
+#include "test_vector.hpp"
+#include "thread_scaling.hpp"
+#include <algorithm>
+#include <string>
+#include <vector>
+
+struct memory_level
+{
+    std::string name;
+    std::size_t bytes;  ///< Working set of the 3 arrays
+    bool        shared; ///< Whether the working set is split between threads
+
+    /** Number of elements of each array for each of `threads` threads. */
+    std::size_t count(unsigned threads) const
+    {
+        std::size_t const per_thread = shared ? bytes / threads : bytes;
+        return std::max<std::size_t>(64, per_thread / (3 * sizeof(double)));
+    }
+};
+
+/**
+ * Working sets that fit in half of each cache level, and one that is 4
+ * times bigger than the last level cache.
+ * All levels but the last one are supposed private to each core.
+ */
+std::vector<memory_level> memory_levels(CacheTopology const& topology)
+{
+    std::vector<memory_level> levels;
+    auto const&               caches = topology.levels();
+    for (std::size_t i = 0; i < caches.size(); ++i) {
+        bool const last = i + 1 == caches.size();
+        levels.push_back({"L" + std::to_string(caches[i].number), caches[i].size / 2, last});
+    }
+    std::size_t const llc = std::max<std::size_t>(topology.last_level_size(), std::size_t(8) << 20);
+    levels.push_back({"DRAM", 4 * llc, false});
+    return levels;
+}
+
+/**
+ * Benchmarks one STREAM kernel on `threads` threads, and records its
+ * bandwidth into `reference`.
+ * @param[in] bytes_per_element  Traffic per element, STREAM way: without
+ *                               write-allocate.
+ */
+template <typename Kernel>
+void bench_stream(
+        ankerl::nanobench::Bench& bench, BandwidthReference& reference, memory_level const& level,
+        std::vector<int> const& cpus, unsigned threads, std::string const& name,
+        std::size_t bytes_per_element, Kernel kernel)
+{
+    std::size_t const count = level.count(threads);
+    // Small working sets are traversed several times per call, for the
+    // barriers of ThreadScaling not to dominate
+    std::size_t const repeat = std::max<std::size_t>(1, (std::size_t(4) << 20) / (count * bytes_per_element));
+    ThreadScaling(cpus, {threads}).run(
+            bench, name, repeat * count * bytes_per_element, [count, repeat, kernel](unsigned thread, unsigned) {
+                // Initialized by the pinned thread: pages are NUMA-local
+                test_vector<double> a(count), b(count), c(count);
+                RNG<double>(rng_seed{3 * thread + 1}, 1, 2, count).fill(a);
+                RNG<double>(rng_seed{3 * thread + 2}, 1, 2, count).fill(b);
+                RNG<double>(rng_seed{3 * thread + 3}, 1, 2, count).fill(c);
+                return [a = std::move(a), b = std::move(b), c = std::move(c), repeat, kernel]() mutable {
+                    for (std::size_t r = 0; r < repeat; ++r) {
+                        kernel(a.data(), b.data(), c.data(), a.size());
+                        ankerl::nanobench::doNotOptimizeAway(a.data());
+                        ankerl::nanobench::doNotOptimizeAway(c.data());
+                    }
+                };
+            });
+
+    // Bytes per second: each measured step moves `batch()` bytes
+    using Measure = ankerl::nanobench::Result::Measure;
+    auto const& r = bench.results().back();
+    reference.set(name, level.name, threads, r.config().mBatch / r.median(Measure::elapsed));
+}
+
+TEST_CASE("STREAM bandwidth")
+{
+    constexpr double       scalar    = 3.0;
+    CacheTopology const    topology  = CacheTopology::detect();
+    std::vector<int> const cpus      = allowed_cpus();
+    unsigned const         all_cores = core_count(cpus);
+    std::vector<unsigned>  thread_counts{1};
+    if (all_cores > 1) thread_counts.push_back(all_cores);
+
+    BandwidthReference reference;
+    for (auto const& level : memory_levels(topology)) {
+        ankerl::nanobench::Bench b;
+        b.title("STREAM " + level.name)
+            .unit("B")
+            .warmup(10)
+            .epochs(21);
+
+        for (auto const threads : thread_counts) {
+            bench_stream(b, reference, level, cpus, threads, "copy", 2 * sizeof(double),
+                    [](double* a, double*, double* c, std::size_t n) {
+                        for (std::size_t i = 0; i < n; ++i) c[i] = a[i];
+                    });
+            bench_stream(b, reference, level, cpus, threads, "scale", 2 * sizeof(double),
+                    [](double*, double* b, double* c, std::size_t n) {
+                        for (std::size_t i = 0; i < n; ++i) b[i] = scalar * c[i];
+                    });
+            bench_stream(b, reference, level, cpus, threads, "add", 3 * sizeof(double),
+                    [](double* a, double* b, double* c, std::size_t n) {
+                        for (std::size_t i = 0; i < n; ++i) c[i] = a[i] + b[i];
+                    });
+            bench_stream(b, reference, level, cpus, threads, "triad", 3 * sizeof(double),
+                    [](double* a, double* b, double* c, std::size_t n) {
+                        for (std::size_t i = 0; i < n; ++i) a[i] = b[i] + scalar * c[i];
+                    });
+        }
+        render_graph(b, "STREAM " + level.name);
+    }
+
+    reference.save();
+    MESSAGE("Bandwidth reference saved to " << BandwidthReference::default_path().string()
+            << ", DRAM peak: " << reference.peak() * 1e-9 << " GB/s");
+}